@@ -0,0 +1,106 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the replacement global operator new and delete that
+  count the heap allocations for --stats (see stats.h). It is linked into the
+  bethyw program only, not the code it shares with the tests and benchmarks,
+  as a replacement applies to the whole of any program it is linked into.
+
+  Each form of operator new allocates with malloc() and, as the defaults do,
+  calls the new_handler and tries again until the allocation succeeds or
+  there is no new_handler. Each form of operator delete frees with free().
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "stats.h"
+
+// GCC 11+ warns that the matching delete frees what malloc() allocated here,
+// which is the point of replacing both
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(std::size_t size)
+{
+	Stats::add(Stats::ALLOCATIONS, 1);
+
+	if (size == 0)
+	{
+		size = 1;
+	}
+
+	void *p;
+	while ((p = std::malloc(size)) == nullptr)
+	{
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		handler();
+	}
+
+	return p;
+}
+
+void *operator new[](std::size_t size)
+{
+	return ::operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+	try
+	{
+		return ::operator new(size);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+	return ::operator new(size, std::nothrow);
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+	std::free(p);
+}
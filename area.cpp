@@ -19,6 +19,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include "area.h"
+#include "view.h"
 #include "bethyw.h"
 
 /*
@@ -32,7 +33,89 @@
   @example
 	Area("W06000023");
 */
-Area::Area(const std::string localAuthorityCode) : localAuthorityCode(localAuthorityCode) {}
+Area::Area(const std::string localAuthorityCode) : localAuthorityCode(SymbolTable::intern(localAuthorityCode)) {}
+
+/*
+  As above, but for a local authority code that has already been interned, e.g.
+  by an importer.
+
+  @param localAuthorityCode
+	The Symbol of the local authority code of the Area
+
+  @param alloc
+	The allocator for the names and measures, e.g. that of the Areas object
+	the Area will be added to. By default, they are allocated from the heap.
+
+  @example
+	Area(SymbolTable::intern("W06000023"));
+*/
+Area::Area(Symbol localAuthorityCode, const allocator_type &alloc)
+	: localAuthorityCode(localAuthorityCode),
+	  names(alloc),
+	  measures(alloc) {}
+
+/*
+  Copy an Area, allocating the names and measures of the copy (and their
+  readings) with the given allocator, e.g. to copy it into the Arena of an
+  Areas object.
+
+  @param other
+	The Area to copy
+
+  @param alloc
+	The allocator for the copy
+
+  @example
+	Area copy(area, areas.getAllocator());
+*/
+Area::Area(const Area &other, const allocator_type &alloc)
+	: localAuthorityCode(other.localAuthorityCode),
+	  names(other.names, alloc),
+	  measures(alloc)
+{
+	for (auto &measure : other.measures)
+	{
+		this->measures.emplace_hint(this->measures.end(), measure.first, Measure(measure.second, alloc));
+	}
+}
+
+/*
+  Move an Area, allocating the names and measures with the given allocator.
+  They are only copied if they were allocated by a different allocator (e.g.
+  from the heap or another Arena).
+
+  @param other
+	The Area to move
+
+  @param alloc
+	The allocator for the new Area
+
+  @example
+	Area moved(std::move(area), areas.getAllocator());
+*/
+Area::Area(Area &&other, const allocator_type &alloc)
+	: localAuthorityCode(other.localAuthorityCode),
+	  names(std::move(other.names), alloc),
+	  measures(alloc)
+{
+	if (other.getAllocator() == alloc)
+	{
+		this->measures = std::move(other.measures);
+		return;
+	}
+
+	for (auto &measure : other.measures)
+	{
+		this->measures.emplace_hint(this->measures.end(), measure.first, Measure(std::move(measure.second), alloc));
+	}
+}
+
+// Auxiliary method to get the allocator of the names and measures, e.g. to
+// create a Measure in the same Arena before adding it
+Area::allocator_type Area::getAllocator() const noexcept
+{
+	return allocator_type(this->measures.get_allocator());
+}
 
 /*
   TODO: Area::getLocalAuthorityCode()
@@ -49,6 +132,12 @@ Area::Area(const std::string localAuthorityCode) : localAuthorityCode(localAutho
 	auto authCode = area.getLocalAuthorityCode();
 */
 const std::string &Area::getLocalAuthorityCode() const
+{
+	return SymbolTable::resolve(this->localAuthorityCode);
+}
+
+// Auxiliary method to get the Symbol of the local authority code
+Symbol Area::getLocalAuthorityCodeSymbol() const noexcept
 {
 	return this->localAuthorityCode;
 }
@@ -79,11 +168,15 @@ const std::string &Area::getLocalAuthorityCode() const
 */
 const std::string &Area::getName(const std::string &lang) const
 {
-	for (auto it = this->names.begin(); it != this->names.end(); ++it)
+	// Names are stored under the Symbol of the lowercase language code. If
+	// that has never been interned, there is no name in that language
+	Symbol key;
+	if (SymbolTable::findFolded(lang, key))
 	{
-		if (strcasecmp(it->first.c_str(), lang.c_str()) == 0)
+		auto it = this->names.find(key);
+		if (it != this->names.end())
 		{
-			return it->second;
+			return SymbolTable::resolve(it->second);
 		}
 	}
 
@@ -131,19 +224,26 @@ void Area::setName(std::string lang, std::string name)
 		}
 	}
 
-	std::transform(lang.begin(), lang.end(), lang.begin(), tolower);
+	this->setName(SymbolTable::intern(lang), SymbolTable::intern(name));
+}
 
-	for (auto it = this->names.begin(); it != this->names.end(); ++it)
-	{
-		if (strcasecmp(it->first.c_str(), lang.c_str()) == 0)
-		{
-			this->names[lang] = name;
-			return;
-		}
-	}
+/*
+  As above, but for a language code and name that have already been interned,
+  e.g. by an importer. The language code is not checked, but is converted to
+  lowercase.
 
-	// language does not exist, insert
-	this->names.insert(std::make_pair(lang, name));
+  @param lang
+	The Symbol of a three-letter language code in ISO 639-3 format
+
+  @param name
+	The Symbol of the name of the Area in `lang`
+
+  @example
+	area.setName(SymbolTable::intern("eng"), SymbolTable::intern("Powys"));
+*/
+void Area::setName(Symbol lang, Symbol name)
+{
+	this->names[SymbolTable::fold(lang)] = name;
 }
 
 /*
@@ -172,9 +272,13 @@ void Area::setName(std::string lang, std::string name)
 */
 Measure &Area::getMeasure(const std::string &key) const
 {
-	for (auto it = this->measures.begin(); it != this->measures.end(); ++it)
+	// Measures are stored under the Symbol of their lowercase codename. If
+	// that has never been interned, there is no such measure
+	Symbol codename;
+	if (SymbolTable::findFolded(key, codename))
 	{
-		if (strcasecmp(it->first.c_str(), key.c_str()) == 0)
+		auto it = this->measures.find(codename);
+		if (it != this->measures.end())
 		{
 			return it->second;
 		}
@@ -217,32 +321,110 @@ Measure &Area::getMeasure(const std::string &key) const
 */
 void Area::setMeasure(const std::string codename, Measure measure)
 {
+	this->setMeasure(SymbolTable::intern(codename), std::move(measure));
+}
 
-	for (auto it = this->measures.begin(); it != this->measures.end(); ++it)
+/*
+  As above, but for a codename that has already been interned, e.g. by an
+  importer.
+
+  @param codename
+	The Symbol of the codename for the Measure
+
+  @param measure
+	The Measure object
+
+  @return
+	void
+
+  @example
+	area.setMeasure(measure.getCodenameSymbol(), measure);
+*/
+void Area::setMeasure(Symbol codename, Measure measure)
+{
+	// Measures are stored under their lowercase codename, so that getMeasure
+	// is case-insensitive
+	Symbol key = SymbolTable::fold(codename);
+	auto existing = this->measures.find(key);
+
+	if (existing != this->measures.end())
 	{
-		if (strcasecmp(it->first.c_str(), codename.c_str()) == 0)
+		// If an existing measure is found
+		// replace the label and all the years + value
+		existing->second.setLabel(measure.getLabelSymbol());
+
+		for (auto reading : measure)
 		{
-			// If an existing measure is found
-			// replace the label and all the years + value
-			it->second.setLabel(measure.getLabel());
-
-			std::vector<unsigned int> years = measure.getAllYears();
-			for (size_t i = 0; i < years.size(); i++)
-			{
-				it->second.setValue(years[i], measure.getValue(years[i]));
-			}
-
-			// Exit method, dont run insertion code
-			return;
+			existing->second.setValue(reading.year, reading.value);
 		}
+
+		return;
+	}
+
+	this->measures.emplace(key, Measure(std::move(measure), this->getAllocator()));
+}
+
+/*
+  Find the Measure with a codename in this Area, or create an empty one if
+  there is none, and give it a label. Unlike setMeasure(), no Measure has to be
+  built first, so an importer can write each value straight into the Measure
+  it belongs to.
+
+  @param codename
+	The Symbol of the codename for the Measure
+
+  @param label
+	The Symbol of the label for the Measure, which replaces any existing label
+
+  @return
+	The Measure in this Area
+
+  @example
+	Area area("W06000023");
+	area.upsertMeasure(SymbolTable::intern("pop"), SymbolTable::intern("Population"))
+		.setValue(1999, 12345678.9);
+*/
+Measure &Area::upsertMeasure(Symbol codename, Symbol label)
+{
+	Symbol key = SymbolTable::fold(codename);
+	auto existing = this->measures.find(key);
+
+	if (existing != this->measures.end())
+	{
+		existing->second.setLabel(label);
+		return existing->second;
+	}
+
+	return this->measures.emplace(key, Measure(codename, label, this->getAllocator())).first->second;
+}
+
+/*
+  Merge the names and Measures of another Area into this one, as if each was
+  set with setName() and setMeasure(). Those of the other Area take precedence.
+
+  @param other
+	The Area to merge into this one, which is left in an unspecified state
+
+  @return
+	void
+
+  @example
+	Area area("W06000023");
+	Area update("W06000023");
+	...
+	area.merge(std::move(update));
+*/
+void Area::merge(Area &&other)
+{
+	for (auto &name : other.names)
+	{
+		this->names[name.first] = name.second;
 	}
 
-	// If the value was not overwritten then we insert
-	// We copy the name and convert it to lowercase (we cant modify original because const)
-	// This has to be lowercase for getMeasure and sorting to work correctly
-	std::string codenameLower(codename.size(), 0);
-	std::transform(codename.begin(), codename.end(), codenameLower.begin(), ::tolower);
-	this->measures.insert(std::make_pair(codenameLower, measure));
+	for (auto &measure : other.measures)
+	{
+		this->setMeasure(measure.first, std::move(measure.second));
+	}
 }
 
 /*
@@ -280,7 +462,7 @@ const std::vector<std::string> Area::getAllNames() const noexcept
 	std::vector<std::string> keys;
 	for (auto it = this->names.begin(); it != this->names.end(); ++it)
 	{
-		keys.push_back(it->first);
+		keys.push_back(SymbolTable::resolve(it->first));
 	}
 
 	// Sort keys alphabetically
@@ -300,7 +482,7 @@ const std::vector<std::string> Area::getAllMeasureCodenames() const noexcept
 	std::vector<std::string> keys;
 	for (auto it = this->measures.begin(); it != this->measures.end(); ++it)
 	{
-		keys.push_back(it->first);
+		keys.push_back(SymbolTable::resolve(it->first));
 	}
 
 	// Sort keys alphabetically
@@ -344,48 +526,36 @@ const std::vector<std::string> Area::getAllMeasureCodenames() const noexcept
 	area.setName("eng", "Powys");
 	std::cout << area << std::endl;
 */
-std::ostream &operator<<(std::ostream &os, Area &area)
+std::ostream &operator<<(std::ostream &os, const Area &area)
 {
-	auto areaNames = area.getAllNames();
+	std::string table;
+	appendTable(table, area);
+	os.write(table.data(), table.size());
 
-	// if no english or welsh name output "Unnamed"
-	if (areaNames.empty())
-	{
-		os << "Unnamed";
-	}
-
-	// If english or/and welsh is set, output them
-	for (size_t i = 0; i < areaNames.size(); i++)
-	{
-		os << area.getName(areaNames[i]);
-
-		if (i < areaNames.size() - 1)
-		{
-			os << " / ";
-		}
-	}
-
-	os << " (" << area.getLocalAuthorityCode() << ")" << std::endl;
+	return os;
+}
 
-	auto measureCodenames = area.getAllMeasureCodenames();
+/*
+  Append the output of operator<< for an Area, i.e. its names followed by the
+  table of each of its measures, to a string.
 
-	// If no measurement code (i.e. no measures) output "<no measures>"
-	if (measureCodenames.empty())
-	{
-		os << "<no measures>\n"
-		   << std::endl;
+  @param out
+	The string to append the tables to
 
-		return os;
-	}
-
-	for (size_t i = 0; i < measureCodenames.size(); i++)
-	{
-		auto measure = area.getMeasure(measureCodenames[i]);
+  @param area
+	The Area to output
 
-		os << measure;
-	}
+  @return
+	void
 
-	return os;
+  @example
+	std::string tables;
+	appendTable(tables, area);
+	std::cout << tables;
+*/
+void appendTable(std::string &out, const Area &area)
+{
+	appendTable(out, AreaView(area));
 }
 
 /*
@@ -413,43 +583,11 @@ std::ostream &operator<<(std::ostream &os, Area &area)
 */
 bool operator==(const Area &a1, const Area &a2)
 {
-	if (a1.getLocalAuthorityCode() != a2.getLocalAuthorityCode() ||
-		a1.size() != a2.size())
-	{
-		return false;
-	}
-
-	std::vector<std::string> names = a1.getAllNames();
-	for (size_t i = 0; i < names.size(); i++)
-	{
-		try
-		{
-			if (a1.getName(names[i]) != a2.getName(names[i]))
-			{
-				return false;
-			}
-		}
-		catch (const std::out_of_range &e)
-		{
-			return false;
-		}
-	}
-
-	auto measureCodenames = a1.getAllMeasureCodenames();
-	for (size_t i = 0; i < measureCodenames.size(); i++)
-	{
-		try
-		{
-			if (!(a1.getMeasure(measureCodenames[i]) == a2.getMeasure(measureCodenames[i])))
-			{
-				return false;
-			}
-		}
-		catch (const std::out_of_range &e)
-		{
-			return false;
-		}
-	}
-
-	return true;
+	// Names and measures are kept in maps ordered by Symbol, so the two Areas
+	// are equal if walking their maps side by side finds the same entries
+	return a1.localAuthorityCode == a2.localAuthorityCode &&
+		   a1.names.size() == a2.names.size() &&
+		   a1.measures.size() == a2.measures.size() &&
+		   std::equal(a1.names.begin(), a1.names.end(), a2.names.begin()) &&
+		   std::equal(a1.measures.begin(), a1.measures.end(), a2.measures.begin());
 }
\ No newline at end of file
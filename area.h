@@ -21,6 +21,9 @@
 
 #include "measure.h"
 
+class AreaView;
+class AreasView;
+
 /*
   An Area object consists of a unique authority code, a container for names
   for the area in any number of different languages, and a container for the
@@ -33,26 +36,59 @@
 class Area
 {
 private:
-	const std::string localAuthorityCode;
-	std::map<std::string, std::string> names;
-	mutable std::map<std::string, Measure> measures;
+	const Symbol localAuthorityCode;
+
+	// Names and measures are keyed on the Symbol of the lowercase language code
+	// and measure codename respectively
+	std::map<Symbol, Symbol, std::less<Symbol>, ArenaAllocator<std::pair<const Symbol, Symbol>>> names;
+	mutable std::map<Symbol, Measure, std::less<Symbol>, ArenaAllocator<std::pair<const Symbol, Measure>>> measures;
+
+	// Views select from the names and measures without looking each one up
+	friend class AreaView;
+	friend class AreasView;
 
 public:
+	/*
+	  The allocator for the names and measures (and their readings), which
+	  allocates from the Arena of the Areas object the Area is in (or from the
+	  heap if it is in none).
+	*/
+	using allocator_type = ArenaAllocator<char>;
+
 	Area(const std::string localAuthorityCode);
+	Area(Symbol localAuthorityCode, const allocator_type &alloc = allocator_type());
+	Area(const Area &other) = default;
+
+	// A moved Area keeps the allocator of the one it was moved from, so an
+	// Area moved out of an Areas object must not outlive that object. To take
+	// one out, copy it, or move it to the heap with
+	// Area(std::move(area), Area::allocator_type())
+	Area(Area &&other) = default;
+	Area(const Area &other, const allocator_type &alloc);
+	Area(Area &&other, const allocator_type &alloc);
+
+	allocator_type getAllocator() const noexcept;
 	const std::string &getLocalAuthorityCode() const;
+	Symbol getLocalAuthorityCodeSymbol() const noexcept;
 
 	const std::string &getName(const std::string &lang) const;
 	void setName(std::string lang, const std::string name);
+	void setName(Symbol lang, Symbol name);
 
 	Measure &getMeasure(const std::string &key) const;
 	void setMeasure(const std::string codename, Measure measure);
+	void setMeasure(Symbol codename, Measure measure);
+	Measure &upsertMeasure(Symbol codename, Symbol label);
+	void merge(Area &&other);
 
 	const std::vector<std::string> getAllNames() const noexcept;
 	const std::vector<std::string> getAllMeasureCodenames() const noexcept;
 
 	const int size() const;
 	friend bool operator==(const Area &a1, const Area &a2);
-	friend std::ostream &operator<<(std::ostream &os, Area &area);
+	friend std::ostream &operator<<(std::ostream &os, const Area &area);
 };
 
+void appendTable(std::string &out, const Area &area);
+
 #endif // AREA_H_
\ No newline at end of file
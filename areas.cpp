@@ -18,23 +18,473 @@
 */
 
 #include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <string>
 #include <stdexcept>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "lib_json.hpp"
 
 #include "datasets.h"
 #include "areas.h"
+#include "csv.h"
+#include "filter.h"
 #include "measure.h"
+#include "stats.h"
+#include "view.h"
 
 /*
   An alias for the imported JSON parsing library.
 */
 using json = nlohmann::json;
 
+/*
+  A SAX event handler for the StatsWales JSON format.
+
+  Rather than materialising the whole document as a json object, the parser
+  reports each token to this handler. We only keep the columns named in cols
+  for the row of value[] that is currently being read, and once that row's
+  object closes it is imported into the Areas instance. Everything else (e.g.
+  odata.metadata, RowKey, *_SortOrder) is discarded as soon as it is read, so
+  memory use does not grow with the size of the file.
+
+  The nesting of the document we care about is:
+	{                       depth 1
+	  "value": [            depth 2
+		{ "<column>": ... } depth 3 (a row)
+	  ]
+	}
+*/
+class WelshStatsJSONHandler : public json::json_sax_t
+{
+private:
+	static constexpr unsigned int NUM_COLUMNS = BethYw::VALUE + 1;
+
+	Areas &areas;
+	const BethYw::SourceColumnMapping &cols;
+	const AreaFilterMatcher areasMatcher;
+
+	// The values of each column that are interned, and the Symbol for "eng"
+	SymbolCache codes;
+	SymbolCache names;
+	SymbolCache measureCodes;
+	SymbolCache measureNames;
+	const Symbol eng = SymbolTable::intern("eng");
+	const StringFilterSet *const measuresFilter;
+	const YearFilterTuple *const yearsFilter;
+
+	// Whether each filter removes anything, and whether the dataset has a
+	// measure code column (otherwise it has a single measure for every row)
+	const bool filterAreas;
+	const bool filterMeasures;
+	const bool filterYears;
+	const bool hasMeasureCode;
+
+	// Every row is filtered out, if the single measure of the dataset is not
+	// in the measures filter
+	bool rejectAll = false;
+
+	// The column headings we want to extract, and the SourceColumn each maps to.
+	// More than one SourceColumn may share a heading (e.g. in envi0201.json)
+	std::vector<std::pair<std::string, BethYw::SourceColumn>> watched;
+
+	unsigned int depth = 0;
+	bool valueKey = false;
+	bool inValueArray = false;
+	bool inRow = false;
+
+	// Bitmasks (indexed by SourceColumn) of the columns the current key maps to,
+	// and of the columns seen so far in the current row
+	unsigned int keyColumns = 0;
+	unsigned int rowColumns = 0;
+
+	// The filters are checked as soon as the columns they need have been read,
+	// so once a row has been filtered out the rest of its columns are skipped.
+	// This is a bitmask of the filters checked so far in the current row
+	enum RowFilter
+	{
+		YEAR_FILTER = 1,
+		AREA_FILTER = 2,
+		MEASURE_FILTER = 4
+	};
+	unsigned int rowFilters = 0;
+	bool rowRejected = false;
+
+	std::string fields[NUM_COLUMNS];
+	bool valueIsNumber = false;
+	double numericValue = 0;
+
+	// What was read and filtered out, for Stats
+	std::uint64_t rowsRead = 0;
+	std::uint64_t rowsFilteredArea = 0;
+	std::uint64_t rowsFilteredMeasure = 0;
+	std::uint64_t rowsFilteredYear = 0;
+
+	void storeField(const std::string &val)
+	{
+		for (unsigned int c = 0; c < NUM_COLUMNS; c++)
+		{
+			if (keyColumns & (1u << c))
+			{
+				fields[c] = val;
+				if (c == BethYw::VALUE)
+				{
+					valueIsNumber = false;
+				}
+			}
+		}
+
+		rowColumns |= keyColumns;
+		keyColumns = 0;
+		filterRow(false);
+	}
+
+	// Store a number, which is only formatted as text if it is for a column
+	// other than the value
+	template <typename Number>
+	void storeNumber(Number val)
+	{
+		if (keyColumns & (1u << BethYw::VALUE))
+		{
+			valueIsNumber = true;
+			numericValue = val;
+			rowColumns |= 1u << BethYw::VALUE;
+			keyColumns &= ~(1u << BethYw::VALUE);
+		}
+
+		if (keyColumns)
+		{
+			storeField(std::to_string(val));
+		}
+	}
+
+	// Return the field for column, throwing if the current row did not have it
+	const std::string &field(BethYw::SourceColumn column) const
+	{
+		if (!(rowColumns & (1u << column)))
+		{
+			throw std::runtime_error("Malformed file: row is missing column " + cols.at(column));
+		}
+
+		return fields[column];
+	}
+
+	bool filterRow(bool complete);
+	void importRow();
+
+public:
+	WelshStatsJSONHandler(Areas &areas,
+						  const BethYw::SourceColumnMapping &cols,
+						  const StringFilterSet *const areasFilter,
+						  const StringFilterSet *const measuresFilter,
+						  const YearFilterTuple *const yearsFilter)
+		: areas(areas),
+		  cols(cols),
+		  areasMatcher(areasFilter),
+		  measuresFilter(measuresFilter),
+		  yearsFilter(yearsFilter),
+		  filterAreas(!areasMatcher.matchesAll()),
+		  filterMeasures(measuresFilter != nullptr && !measuresFilter->empty()),
+		  filterYears(yearsFilter != nullptr && std::get<0>(*yearsFilter) != 0 && std::get<1>(*yearsFilter) != 0),
+		  hasMeasureCode(cols.find(BethYw::MEASURE_CODE) != cols.end())
+	{
+		const BethYw::SourceColumn columns[] = {BethYw::AUTH_CODE,
+												BethYw::AUTH_NAME_ENG,
+												BethYw::MEASURE_CODE,
+												BethYw::MEASURE_NAME,
+												BethYw::YEAR,
+												BethYw::VALUE};
+
+		for (auto column : columns)
+		{
+			auto it = cols.find(column);
+			if (it != cols.end())
+			{
+				watched.push_back(std::make_pair(it->second, column));
+			}
+		}
+
+		// A dataset with a single measure only needs checking once
+		if (!hasMeasureCode && filterMeasures)
+		{
+			rejectAll = measuresFilter->find(toLowercase(cols.at(BethYw::SINGLE_MEASURE_CODE))) == measuresFilter->end();
+		}
+	}
+
+	bool null() override
+	{
+		keyColumns = 0;
+		return true;
+	}
+
+	bool boolean(bool) override
+	{
+		keyColumns = 0;
+		return true;
+	}
+
+	bool number_integer(number_integer_t val) override
+	{
+		if (keyColumns)
+		{
+			storeNumber(val);
+		}
+		return true;
+	}
+
+	bool number_unsigned(number_unsigned_t val) override
+	{
+		if (keyColumns)
+		{
+			storeNumber(val);
+		}
+		return true;
+	}
+
+	bool number_float(number_float_t val, const string_t &s) override
+	{
+		if (keyColumns & (1u << BethYw::VALUE))
+		{
+			valueIsNumber = true;
+			numericValue = val;
+			rowColumns |= 1u << BethYw::VALUE;
+			keyColumns &= ~(1u << BethYw::VALUE);
+		}
+
+		if (keyColumns)
+		{
+			storeField(s);
+		}
+		return true;
+	}
+
+	bool string(string_t &val) override
+	{
+		if (keyColumns)
+		{
+			storeField(val);
+		}
+		return true;
+	}
+
+	bool binary(binary_t &) override
+	{
+		keyColumns = 0;
+		return true;
+	}
+
+	bool start_object(std::size_t) override
+	{
+		keyColumns = 0;
+		depth++;
+
+		if (depth == 3 && inValueArray)
+		{
+			inRow = true;
+			rowColumns = 0;
+			rowFilters = 0;
+			rowRejected = rejectAll;
+			valueIsNumber = false;
+		}
+		return true;
+	}
+
+	bool end_object() override
+	{
+		if (depth == 3 && inRow)
+		{
+			inRow = false;
+			importRow();
+		}
+
+		depth--;
+		return true;
+	}
+
+	bool start_array(std::size_t) override
+	{
+		keyColumns = 0;
+		depth++;
+
+		if (depth == 2 && valueKey)
+		{
+			inValueArray = true;
+		}
+		return true;
+	}
+
+	bool end_array() override
+	{
+		if (depth == 2)
+		{
+			inValueArray = false;
+		}
+
+		depth--;
+		return true;
+	}
+
+	bool key(string_t &val) override
+	{
+		keyColumns = 0;
+
+		if (depth == 1)
+		{
+			valueKey = val == "value";
+		}
+		else if (depth == 3 && inRow && !rowRejected)
+		{
+			for (auto &column : watched)
+			{
+				if (column.first == val)
+				{
+					keyColumns |= 1u << column.second;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex) override
+	{
+		throw std::runtime_error(std::string("Malformed file: ") + ex.what());
+	}
+
+	// Add what was read and filtered out to the Stats counters, once the
+	// whole document has been parsed
+	void addStats() const
+	{
+		Stats::add(Stats::ROWS_READ, rowsRead);
+		Stats::add(Stats::ROWS_FILTERED_AREA, rowsFilteredArea);
+		Stats::add(Stats::ROWS_FILTERED_MEASURE, rowsFilteredMeasure);
+		Stats::add(Stats::ROWS_FILTERED_YEAR, rowsFilteredYear);
+	}
+};
+
+// Check the filters that have not been checked yet for the current row, if
+// the columns they need have been read, cheapest first: the year, then the
+// area, then the measure. Once the row is complete, every filter is checked
+// (and a missing column is an error). Returns false if the row is filtered out
+bool WelshStatsJSONHandler::filterRow(bool complete)
+{
+	if (this->rowRejected)
+	{
+		return false;
+	}
+
+	const unsigned int yearColumns = 1u << BethYw::YEAR;
+	const unsigned int areaColumns = (1u << BethYw::AUTH_CODE) | (1u << BethYw::AUTH_NAME_ENG);
+	const unsigned int measureColumns = 1u << BethYw::MEASURE_CODE;
+
+	// Check year filter, skip if year is not within the filter
+	if (!(this->rowFilters & YEAR_FILTER) && (complete || (this->rowColumns & yearColumns) == yearColumns))
+	{
+		this->rowFilters |= YEAR_FILTER;
+
+		if (this->filterYears)
+		{
+			unsigned int measureYear = std::stoi(field(BethYw::YEAR));
+			if (measureYear < std::get<0>(*yearsFilter) || measureYear > std::get<1>(*yearsFilter))
+			{
+				this->rowsFilteredYear++;
+				this->rowRejected = true;
+				return false;
+			}
+		}
+	}
+
+	// Check if area code or english name is in area filter
+	// If none are found then skip (do not import) this area
+	if (!(this->rowFilters & AREA_FILTER) && (complete || (this->rowColumns & areaColumns) == areaColumns))
+	{
+		this->rowFilters |= AREA_FILTER;
+
+		if (this->filterAreas &&
+			!this->areasMatcher.matches(field(BethYw::AUTH_CODE)) &&
+			!this->areasMatcher.matches(field(BethYw::AUTH_NAME_ENG)))
+		{
+			this->rowsFilteredArea++;
+			this->rowRejected = true;
+			return false;
+		}
+	}
+
+	// Check measure filter, skip if measure is not in filter. The folded
+	// Symbol of the code gives its lowercase string without converting it. A
+	// single measure dataset was checked in the constructor
+	if (!(this->rowFilters & MEASURE_FILTER) && (complete || (this->rowColumns & measureColumns) == measureColumns))
+	{
+		this->rowFilters |= MEASURE_FILTER;
+
+		if (this->filterMeasures && this->hasMeasureCode)
+		{
+			Symbol measureCodeSymbol = this->measureCodes.intern(field(BethYw::MEASURE_CODE));
+			const std::string &measureCodeLower = SymbolTable::resolve(SymbolTable::fold(measureCodeSymbol));
+
+			if (measuresFilter->find(measureCodeLower) == measuresFilter->end())
+			{
+				this->rowsFilteredMeasure++;
+				this->rowRejected = true;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Import the row that has just been read, if it was not filtered out. The
+// value is only decoded for the rows that are imported
+void WelshStatsJSONHandler::importRow()
+{
+	this->rowsRead++;
+
+	if (this->rowRejected)
+	{
+		if (this->rejectAll)
+		{
+			this->rowsFilteredMeasure++;
+		}
+		return;
+	}
+
+	if (!this->filterRow(true))
+	{
+		return;
+	}
+
+	const std::string &localAuthorityCode = field(BethYw::AUTH_CODE);
+	const std::string &englishName = field(BethYw::AUTH_NAME_ENG);
+
+	// Get measure code if available. Some datasets have a single measure
+	// for the entire dataset and use SINGLE_MEASURE_CODE instead of MEASURE_CODE
+	const std::string &measureCode = hasMeasureCode ? field(BethYw::MEASURE_CODE) : cols.at(BethYw::SINGLE_MEASURE_CODE);
+	const std::string &measureName = hasMeasureCode ? field(BethYw::MEASURE_NAME) : cols.at(BethYw::SINGLE_MEASURE_NAME);
+
+	unsigned int measureYear = std::stoi(field(BethYw::YEAR));
+
+	// Convert value to decimal using stod if value is a string,
+	// otherwise use the value without conversion
+	const std::string &valueField = field(BethYw::VALUE);
+	double measureValue = this->valueIsNumber ? this->numericValue : std::stod(valueField);
+
+	areas.upsertValue(this->codes.intern(localAuthorityCode),
+					  this->measureCodes.intern(measureCode),
+					  this->measureNames.intern(measureName),
+					  measureYear,
+					  measureValue)
+		.setName(this->eng, this->names.intern(englishName));
+}
+
 /*
   TODO: Areas::Areas()
 
@@ -43,7 +493,91 @@ using json = nlohmann::json;
   @example
 	Areas data = Areas();
 */
-Areas::Areas() {}
+Areas::Areas()
+	: arena(new Arena()),
+	  container(AreasContainer::allocator_type(arena.get())),
+	  authorityIndex(AreasContainer::allocator_type(arena.get())) {}
+
+/*
+  Copy an Areas object. The copy has its own Arena, into which all the Area
+  objects are copied.
+
+  @param other
+	The Areas object to copy
+
+  @example
+	Areas copy(areas);
+*/
+Areas::Areas(const Areas &other) : Areas()
+{
+	for (auto &entry : other.container)
+	{
+		this->container.emplace(entry.first, Area(entry.second, this->getAllocator()));
+	}
+
+	this->authorityIndex.insert(other.authorityIndex.begin(), other.authorityIndex.end());
+}
+
+/*
+  Move an Areas object. The new object takes over the Arena (and so nothing is
+  copied), and other is left empty with a new Arena of its own.
+
+  @param other
+	The Areas object to move
+
+  @example
+	Areas moved(std::move(areas));
+*/
+Areas::Areas(Areas &&other) : Areas()
+{
+	this->swap(other);
+}
+
+/*
+  Replace the contents of this Areas object with a copy of another (or with the
+  other itself, if it is moved).
+
+  @param other
+	The Areas object to copy or move
+
+  @return
+	This Areas object
+
+  @example
+	partial = areas;
+*/
+Areas &Areas::operator=(Areas other)
+{
+	this->swap(other);
+	return *this;
+}
+
+/*
+  Swap the contents of two Areas objects, including their Arenas, so that
+  nothing is copied.
+
+  @param other
+	The Areas object to swap with
+
+  @return
+	void
+*/
+void Areas::swap(Areas &other) noexcept
+{
+	this->arena.swap(other.arena);
+	this->container.swap(other.container);
+	this->authorityIndex.swap(other.authorityIndex);
+	this->measureIndex.swap(other.measureIndex);
+	this->yearIndex.swap(other.yearIndex);
+	std::swap(this->indexed, other.indexed);
+}
+
+// Auxiliary method to get an allocator for the Arena of this Areas object, e.g.
+// to create an Area in it before adding it with setArea()
+Area::allocator_type Areas::getAllocator() const noexcept
+{
+	return Area::allocator_type(this->arena.get());
+}
 
 /*
   TODO: Areas::setArea(localAuthorityCode, area)
@@ -72,31 +606,120 @@ Areas::Areas() {}
 */
 void Areas::setArea(const std::string localAuthorityCode, Area area)
 {
+	this->setArea(SymbolTable::intern(localAuthorityCode), std::move(area));
+}
 
-	for (auto it = this->container.begin(); it != this->container.end(); ++it)
+/*
+  As above, but for a local authority code that has already been interned,
+  e.g. by an importer.
+
+  @param localAuthorityCode
+	The Symbol of the local authority code of the Area
+
+  @param area
+	The Area object that will contain the Measure objects
+
+  @return
+	void
+
+  @example
+	Areas data = Areas();
+	Area area("W06000023");
+	data.setArea(area.getLocalAuthorityCodeSymbol(), area);
+*/
+void Areas::setArea(Symbol localAuthorityCode, Area area)
+{
+	this->indexed = false;
+
+	Symbol key = SymbolTable::fold(localAuthorityCode);
+	auto existing = this->authorityIndex.find(key);
+
+	if (existing != this->authorityIndex.end())
 	{
-		if (strcasecmp(it->first.c_str(), localAuthorityCode.c_str()) == 0)
-		{
-			// If an existing area is found
-			// replace/merge the names and measures
-			auto names = area.getAllNames();
-			for (unsigned int i = 0; i < names.size(); i++)
-			{
-				it->second.setName(names[i], area.getName(names[i]));
-			}
+		// If an existing area is found
+		// replace/merge the names and measures
+		this->container.find(existing->second)->second.merge(std::move(area));
 
-			auto measureCodenames = area.getAllMeasureCodenames();
-			for (unsigned int i = 0; i < measureCodenames.size(); i++)
-			{
-				it->second.setMeasure(measureCodenames[i], area.getMeasure(measureCodenames[i]));
-			}
+		// if overwritten exit method, dont run insertion code
+		return;
+	}
 
-			// if overwritten exit method, dont run insertion code
-			return;
-		}
+	this->container.emplace(localAuthorityCode, Area(std::move(area), this->getAllocator()));
+	this->authorityIndex.insert(std::make_pair(key, localAuthorityCode));
+}
+
+// Auxiliary method to find the Area with a local authority code, or to create
+// an empty one (in the Arena) if there is none
+Area &Areas::upsertArea(Symbol localAuthorityCode)
+{
+	this->indexed = false;
+
+	Symbol key = SymbolTable::fold(localAuthorityCode);
+	auto existing = this->authorityIndex.find(key);
+
+	if (existing != this->authorityIndex.end())
+	{
+		return this->container.find(existing->second)->second;
 	}
 
-	this->container.insert(std::make_pair(localAuthorityCode, area));
+	this->authorityIndex.insert(std::make_pair(key, localAuthorityCode));
+	return this->container.emplace(localAuthorityCode, Area(localAuthorityCode, this->getAllocator())).first->second;
+}
+
+/*
+  Set a single value of a Measure of an Area, creating the Area and Measure if
+  they do not exist yet. This is equivalent to calling setArea() with an Area
+  that has a Measure with only this value, but the value is written straight
+  into the existing Area and Measure, and so nothing is built and merged.
+
+  @param localAuthorityCode
+	The local authority code of the Area
+
+  @param codename
+	The codename of the Measure
+
+  @param label
+	The label of the Measure, which replaces any existing label
+
+  @param year
+	The year of the value
+
+  @param value
+	The value of the Measure in year
+
+  @return
+	The Area the value was set in, e.g. to also set its name
+
+  @example
+	Areas data = Areas();
+	data.upsertValue("W06000023", "pop", "Population", 2015, 132976);
+*/
+Area &Areas::upsertValue(const std::string &localAuthorityCode,
+						 const std::string &codename,
+						 const std::string &label,
+						 unsigned int year,
+						 double value)
+{
+	return this->upsertValue(SymbolTable::intern(localAuthorityCode),
+							 SymbolTable::intern(codename),
+							 SymbolTable::intern(label),
+							 year,
+							 value);
+}
+
+/*
+  As above, but for a local authority code, codename and label that have
+  already been interned, e.g. by an importer.
+
+  @example
+	data.upsertValue(code, codename, label, 2015, 132976).setName(eng, name);
+*/
+Area &Areas::upsertValue(Symbol localAuthorityCode, Symbol codename, Symbol label, unsigned int year, double value)
+{
+	Area &area = this->upsertArea(localAuthorityCode);
+	area.upsertMeasure(codename, label).setValue(year, value);
+
+	return area;
 }
 
 /*
@@ -124,17 +747,169 @@ void Areas::setArea(const std::string localAuthorityCode, Area area)
 */
 Area &Areas::getArea(const std::string &localAuthorityCode)
 {
-	for (auto it = this->container.begin(); it != this->container.end(); ++it)
+	// The Area may be changed through the reference, so the indexes have to
+	// be built again before they are next used
+	this->indexed = false;
+
+	return const_cast<Area &>(static_cast<const Areas &>(*this).getArea(localAuthorityCode));
+}
+
+/*
+  As above, but for an Area that will not be changed, and so which leaves the
+  indexes (see buildIndexes()) as they are.
+
+  @example
+	const Areas &data = areas;
+	auto name = data.getArea("W06000023").getName("eng");
+*/
+const Area &Areas::getArea(const std::string &localAuthorityCode) const
+{
+	// If the lowercase code has never been interned, there is no such area
+	Symbol key;
+	if (SymbolTable::findFolded(localAuthorityCode, key))
 	{
-		if (strcasecmp(it->first.c_str(), localAuthorityCode.c_str()) == 0)
+		auto existing = this->authorityIndex.find(key);
+
+		if (existing != this->authorityIndex.end())
 		{
-			return it->second;
+			return this->container.find(existing->second)->second;
 		}
 	}
 
 	throw std::out_of_range("No area found matching " + localAuthorityCode);
 }
 
+/*
+  Merge all the Area objects of another Areas instance into this one, as if
+  each had been passed to setArea(). The other instance is left empty.
+
+  This is used to combine datasets that were imported into separate Areas
+  instances (e.g. concurrently) back into one.
+
+  @param other
+	The Areas instance to merge into this one
+
+  @return
+	void
+
+  @example
+	Areas data = Areas();
+	Areas partial = Areas();
+	...
+	data.merge(std::move(partial));
+*/
+void Areas::merge(Areas &&other)
+{
+	for (auto it = other.container.begin(); it != other.container.end(); ++it)
+	{
+		this->setArea(it->first, std::move(it->second));
+	}
+
+	other.container.clear();
+	other.authorityIndex.clear();
+	other.measureIndex.clear();
+	other.yearIndex.clear();
+	other.indexed = false;
+}
+
+/*
+  Query the data that matches the filters, as if the datasets had been
+  imported with them, e.g. to answer many queries from one import. The result
+  is a view that refers to the selected Area and Measure objects (and the
+  range of the selected years of each Measure) rather than copying them, and
+  which can be output in the same ways as an Areas object. It is invalidated
+  by any change to this Areas object.
+
+  An area matches the areas filter if any of the filter strings is in its
+  code or one of its names, ignoring case (see AreaFilterMatcher), and a
+  measure matches the measures filter if its codename is in it. If there is a
+  years filter, a measure with no values in the range is left out.
+
+  @param areasFilter
+	An unordered set of areas to filter, or empty (or nullptr) to select all
+	areas
+
+  @param measuresFilter
+	An unordered set of lowercase measure codenames to filter, or empty (or
+	nullptr) to select all measures
+
+  @param yearsFilter
+	An two-pair tuple of unsigned ints corresponding to the range of years
+	to select, which should both be 0 (or nullptr) to select all years
+
+  @return
+	An AreasView of the selected data
+
+  @example
+	auto areasFilter = BethYw::parseAreasArg(args);
+	auto measuresFilter = BethYw::parseMeasuresArg(args);
+	auto yearsFilter = BethYw::parseYearsArg(args);
+
+	std::cout << data.query(&areasFilter, &measuresFilter, &yearsFilter);
+*/
+AreasView Areas::query(const StringFilterSet *const areasFilter,
+					   const StringFilterSet *const measuresFilter,
+					   const YearFilterTuple *const yearsFilter) const
+{
+	return AreasView(*this, areasFilter, measuresFilter, yearsFilter);
+}
+
+/*
+  As query(), but copy the selected data into a new Areas object, which stays
+  valid when this Areas object changes.
+
+  @param areasFilter
+	An unordered set of areas to filter, or empty (or nullptr) to select all
+	areas
+
+  @param measuresFilter
+	An unordered set of lowercase measure codenames to filter, or empty (or
+	nullptr) to select all measures
+
+  @param yearsFilter
+	An two-pair tuple of unsigned ints corresponding to the range of years
+	to select, which should both be 0 (or nullptr) to select all years
+
+  @return
+	A new Areas object with the selected data
+
+  @example
+	Areas selection = data.select(&areasFilter, &measuresFilter, &yearsFilter);
+*/
+Areas Areas::select(const StringFilterSet *const areasFilter,
+					const StringFilterSet *const measuresFilter,
+					const YearFilterTuple *const yearsFilter) const
+{
+	const AreasView view = this->query(areasFilter, measuresFilter, yearsFilter);
+	Areas selection = Areas();
+
+	for (auto &entry : view.getAreas())
+	{
+		const Area &area = entry.second.getArea();
+
+		Area &selected = selection.upsertArea(entry.first);
+		for (auto &language : area.getAllNames())
+		{
+			selected.setName(SymbolTable::intern(language), SymbolTable::intern(area.getName(language)));
+		}
+
+		for (auto &measure : entry.second.getMeasures())
+		{
+			const Measure &source = measure.second.getMeasure();
+			Measure copy(source.getCodenameSymbol(), source.getLabelSymbol(), selected.getAllocator());
+
+			for (auto reading : measure.second)
+			{
+				copy.setValue(reading.year, reading.value);
+			}
+
+			selected.setMeasure(measure.first, std::move(copy));
+		}
+	}
+
+	return selection;
+}
+
 /*
   TODO: Areas::size()
 
@@ -157,6 +932,18 @@ const int Areas::size() const
 {
 	return this->container.size();
 }
+// Auxiliary function to check a CSV field against the areas filter without
+// copying it, unless it has escaped quotes that must be removed first
+static bool matchesField(const AreaFilterMatcher &matcher, const CSVField &field)
+{
+	if (field.escaped)
+	{
+		return matcher.matches(field.str());
+	}
+
+	return matcher.matches(field.begin, field.end);
+}
+
 /*
   TODO: Areas::populateFromAuthorityCodeCSV(is, cols, areasFilter)
 
@@ -213,59 +1000,91 @@ void Areas::populateFromAuthorityCodeCSV(
 	const BethYw::SourceColumnMapping &cols,
 	const StringFilterSet *const areasFilter)
 {
-	std::string line;
-	std::vector<std::string> headings;
-	size_t pos = 0;
+	// The CSV parser works on a contiguous buffer, so read in the whole stream
+	std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
 
-	std::getline(is, line);
+	this->populateFromAuthorityCodeCSV(contents.data(), contents.data() + contents.size(), cols, areasFilter);
+}
 
-	// Read file headings, if it does not match the headings in cols then file is malformed
-	while ((pos = line.find(",")) != std::string::npos)
-	{
-		headings.push_back(line.substr(0, pos));
-		line.erase(0, pos + 1);
-	}
-	headings.push_back(line);
+/*
+  As above, but parse the areas.csv data in the buffer [begin, end), e.g. the
+  contents of an InputMappedFile, rather than a stream.
+
+  @example
+	InputMappedFile input("data/areas.csv");
+	input.open();
 
-	if (headings.size() != 3 ||
-		headings[0] != cols.find(BethYw::AUTH_CODE)->second ||
-		headings[1] != cols.find(BethYw::AUTH_NAME_ENG)->second ||
-		headings[2] != cols.find(BethYw::AUTH_NAME_CYM)->second)
+	Areas data = Areas();
+	areas.populateFromAuthorityCodeCSV(input.begin(), input.end(), cols, &areasFilter);
+*/
+void Areas::populateFromAuthorityCodeCSV(
+	const char *begin,
+	const char *end,
+	const BethYw::SourceColumnMapping &cols,
+	const StringFilterSet *const areasFilter)
+{
+	CSVReader reader(begin, end);
+	std::vector<CSVField> fields;
+
+	reader.next(fields);
+
+	// Read file headings, if it does not match the headings in cols then file is malformed
+	if (fields.size() != 3 ||
+		fields[0] != cols.at(BethYw::AUTH_CODE) ||
+		fields[1] != cols.at(BethYw::AUTH_NAME_ENG) ||
+		fields[2] != cols.at(BethYw::AUTH_NAME_CYM))
 	{
 		throw std::runtime_error("Malformed file: headings are not correct");
 	}
 
-	std::vector<std::string> values;
-	while (std::getline(is, line))
-	{
-		size_t pos = 0;
-		values.clear();
+	const AreaFilterMatcher areasMatcher(areasFilter);
+	const Symbol eng = SymbolTable::intern("eng");
+	const Symbol cym = SymbolTable::intern("cym");
+
+	std::vector<std::string> values(3);
+	std::uint64_t rowsRead = 0;
+	std::uint64_t rowsFilteredArea = 0;
 
-		// Read code, english name and welsh name
-		while ((pos = line.find(",")) != std::string::npos)
+	while (reader.next(fields))
+	{
+		// Skip blank lines
+		if (fields.size() == 1 && fields[0].empty())
 		{
-			values.push_back(line.substr(0, pos));
-			line.erase(0, pos + 1);
+			continue;
 		}
-		values.push_back(line);
 
-		if (values.size() != 3)
+		if (fields.size() != 3)
 		{
 			throw std::out_of_range("Malformed file: incorrect number of columns");
 		}
 
+		rowsRead++;
+
 		// Check if area code, english name or welsh name is in area filter
 		// If none are found then skip (do not import) this area
-		if (!searchStrInAreasFilter(areasFilter, values))
+		if (!areasMatcher.matchesAll() &&
+			!matchesField(areasMatcher, fields[0]) &&
+			!matchesField(areasMatcher, fields[1]) &&
+			!matchesField(areasMatcher, fields[2]))
 		{
+			rowsFilteredArea++;
 			continue;
 		}
 
-		Area area(values[0]);
-		area.setName("eng", values[1]);
-		area.setName("cym", values[2]);
-		this->setArea(values[0], area);
+		// Read code, english name and welsh name. Names may be quoted, e.g. if
+		// they contain a comma
+		for (size_t i = 0; i < 3; i++)
+		{
+			values[i] = fields[i].str();
+		}
+
+		Area &area = this->upsertArea(SymbolTable::intern(values[0]));
+		area.setName(eng, SymbolTable::intern(values[1]));
+		area.setName(cym, SymbolTable::intern(values[2]));
 	}
+
+	Stats::add(Stats::ROWS_READ, rowsRead);
+	Stats::add(Stats::ROWS_FILTERED_AREA, rowsFilteredArea);
 }
 
 /*
@@ -305,6 +1124,10 @@ void Areas::populateFromAuthorityCodeCSV(
   the local authority code, English name (the files only contain the English
   names), and each measure by year.
 
+  The document is read through the SAX interface of the JSON library (see
+  WelshStatsJSONHandler above) rather than parsed into a json object, so only
+  the columns in cols are kept, one row at a time.
+
   If you encounter an Area that does not exist in the Areas container, you
   should create the Area object
 
@@ -378,81 +1201,38 @@ void Areas::populateFromWelshStatsJSON(std::istream &is,
 									   const StringFilterSet *const measuresFilter,
 									   const YearFilterTuple *const yearsFilter)
 {
-	json j;
-	is >> j;
-
-	for (auto &el : j["value"].items())
-	{
-		auto &data = el.value();
-		std::string localAuthorityCode = data[cols.find(BethYw::AUTH_CODE)->second];
-		Area area(localAuthorityCode);
-
-		std::string englishName = data[cols.find(BethYw::AUTH_NAME_ENG)->second];
-		area.setName("eng", englishName);
-
-		std::string measureCode;
-		std::string measureName;
-
-		// Get measure code if available. Some datasets have a single measure
-		// for the entire dataset and use SINGLE_MEASURE_CODE instead of MEASURE_CODE
-		if (cols.find(BethYw::MEASURE_CODE) != cols.end())
-		{
-			measureCode = data[cols.find(BethYw::MEASURE_CODE)->second];
-			measureName = data[cols.find(BethYw::MEASURE_NAME)->second];
-		}
-		else
-		{
-			measureCode = cols.find(BethYw::SINGLE_MEASURE_CODE)->second;
-			measureName = cols.find(BethYw::SINGLE_MEASURE_NAME)->second;
-		}
-
-		unsigned int measureYear = std::stoi(std::string(data[cols.find(BethYw::YEAR)->second]));
-
-		double measureValue;
-		// Convert value to decimal using stod if value is a string,
-		// otherwise use the value without conversion
-		if (data[cols.find(BethYw::VALUE)->second].is_string())
-		{
-			measureValue = std::stod(std::string(data[cols.find(BethYw::VALUE)->second]));
-		}
-		else
-		{
-			measureValue = data[cols.find(BethYw::VALUE)->second];
-		}
-
-		// Check if area code or english name is in area filter
-		// If none are found then skip (do not import) this area
-		if (!searchStrInAreasFilter(areasFilter, {localAuthorityCode, englishName}))
-		{
-			continue;
-		}
-
-		// Check measure filter, skip if measure is not in filter
-		if (measuresFilter != nullptr && !measuresFilter->empty())
-		{
-			transform(measureCode.begin(), measureCode.end(), measureCode.begin(), tolower);
-			if (measuresFilter->find(measureCode) == measuresFilter->end())
-			{
-				continue;
-			}
-		}
-
-		// Check year filter, skip if year is not within the filter
-		if (yearsFilter != nullptr && (std::get<0>(*yearsFilter) != 0 && std::get<1>(*yearsFilter) != 0))
-		{
-			if (measureYear < std::get<0>(*yearsFilter) || measureYear > std::get<1>(*yearsFilter))
-			{
-				continue;
-			}
-		}
+	WelshStatsJSONHandler handler(*this, cols, areasFilter, measuresFilter, yearsFilter);
+	json::sax_parse(is, &handler);
+	handler.addStats();
+}
 
-		Measure measure(measureCode, measureName);
-		measure.setValue(measureYear, measureValue);
+/*
+  As above, but parse the JSON in the buffer [begin, end), e.g. the contents of
+  an InputMappedFile, rather than a stream.
 
-		area.setMeasure(measureCode, measure);
+  @example
+	InputMappedFile input("data/popu1009.json");
+	input.open();
 
-		this->setArea(localAuthorityCode, area);
-	}
+	Areas data = Areas();
+	areas.populateFromWelshStatsJSON(
+	  input.begin(),
+	  input.end(),
+	  cols,
+	  &areasFilter,
+	  &measuresFilter,
+	  &yearsFilter);
+*/
+void Areas::populateFromWelshStatsJSON(const char *begin,
+									   const char *end,
+									   const BethYw::SourceColumnMapping &cols,
+									   const StringFilterSet *const areasFilter,
+									   const StringFilterSet *const measuresFilter,
+									   const YearFilterTuple *const yearsFilter)
+{
+	WelshStatsJSONHandler handler(*this, cols, areasFilter, measuresFilter, yearsFilter);
+	json::sax_parse(begin, end, &handler);
+	handler.addStats();
 }
 /*
   TODO: Areas::populateFromAuthorityByYearCSV(is,
@@ -528,75 +1308,138 @@ void Areas::populateFromAuthorityByYearCSV(
 	const StringFilterSet *const measuresFilter,
 	const YearFilterTuple *const yearsFilter)
 {
-	std::string line;
-	std::getline(is, line);
+	// The CSV parser works on a contiguous buffer, so read in the whole stream
+	std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+	this->populateFromAuthorityByYearCSV(contents.data(),
+										 contents.data() + contents.size(),
+										 cols,
+										 areasFilter,
+										 measuresFilter,
+										 yearsFilter);
+}
+
+/*
+  As above, but parse the CSV data in the buffer [begin, end), e.g. the
+  contents of an InputMappedFile, rather than a stream.
+
+  @example
+	InputMappedFile input("data/complete-popu1009-pop.csv");
+	input.open();
+
+	Areas data = Areas();
+	areas.populateFromAuthorityByYearCSV(
+	  input.begin(),
+	  input.end(),
+	  cols,
+	  &areasFilter,
+	  &measuresFilter,
+	  &yearsFilter);
+*/
+void Areas::populateFromAuthorityByYearCSV(
+	const char *begin,
+	const char *end,
+	const BethYw::SourceColumnMapping &cols,
+	const StringFilterSet *const areasFilter,
+	const StringFilterSet *const measuresFilter,
+	const YearFilterTuple *const yearsFilter)
+{
+	CSVReader reader(begin, end);
+	std::vector<CSVField> fields;
 	std::vector<unsigned int> years;
-	std::size_t pos = 0;
 
-	// Checking if headings are correct
-	if ((pos = line.find(",")) != std::string::npos)
+	// Checking if headings are correct: the authority code followed by years
+	reader.next(fields);
+
+	if (fields.size() < 2 || fields[0] != cols.at(BethYw::AUTH_CODE))
 	{
-		std::string headingAuthCode = line.substr(0, pos);
+		throw std::runtime_error("Malformed file: headings are not correct");
+	}
 
-		if (headingAuthCode != cols.find(BethYw::AUTH_CODE)->second)
+	for (size_t i = 1; i < fields.size(); i++)
+	{
+		unsigned int year;
+		if (!parseCSVYear(fields[i], year))
 		{
 			throw std::runtime_error("Malformed file: headings are not correct");
 		}
 
-		line.erase(0, pos + 1);
+		years.push_back(year);
 	}
 
-	std::string measureCode = cols.find(BethYw::SINGLE_MEASURE_CODE)->second;
-	std::string measureName = cols.find(BethYw::SINGLE_MEASURE_NAME)->second;
+	const std::string &measureCode = cols.at(BethYw::SINGLE_MEASURE_CODE);
+	const std::string &measureName = cols.at(BethYw::SINGLE_MEASURE_NAME);
 
-	// Read each year and push it into vector
-	while ((pos = line.find(",")) != std::string::npos)
+	// The whole file is a single measure, so if it is not in the filter there
+	// is nothing to import
+	if (measuresFilter != nullptr && !measuresFilter->empty() &&
+		measuresFilter->find(toLowercase(measureCode)) == measuresFilter->end())
 	{
-		years.push_back(stoi(line.substr(0, pos)));
-		line.erase(0, pos + 1);
+		return;
 	}
-	years.push_back(stoi(line));
 
-	while (std::getline(is, line))
+	const bool filterYears = yearsFilter != nullptr &&
+							 std::get<0>(*yearsFilter) != 0 &&
+							 std::get<1>(*yearsFilter) != 0;
+
+	const AreaFilterMatcher areasMatcher(areasFilter);
+	const Symbol measureCodeSymbol = SymbolTable::intern(measureCode);
+	const Symbol measureNameSymbol = SymbolTable::intern(measureName);
+
+	std::uint64_t rowsRead = 0;
+	std::uint64_t rowsFilteredArea = 0;
+	std::uint64_t valuesFilteredYear = 0;
+
+	while (reader.next(fields))
 	{
-		// Read local authority code in the current line
-		// and go to the next value after comma
-		std::string localAuthorityCode = line.substr(0, line.find(","));
-		line.erase(0, line.find(",") + 1);
+		// Skip blank lines
+		if (fields.size() == 1 && fields[0].empty())
+		{
+			continue;
+		}
+
+		rowsRead++;
 
-		if (!searchStrInAreasFilter(areasFilter, {localAuthorityCode}))
+		if (!matchesField(areasMatcher, fields[0]))
 		{
+			rowsFilteredArea++;
 			continue;
 		}
 
-		if (measuresFilter != nullptr && !measuresFilter->empty())
+		std::string localAuthorityCode = fields[0].str();
+
+		// The area must have been imported already (e.g. from areas.csv), as
+		// these files have no names. Each field after the authority code is the
+		// value for the year in the same column, which is written straight into
+		// the Measure. A missing or empty field means there is no value
+		Measure &measure = this->getArea(localAuthorityCode).upsertMeasure(measureCodeSymbol, measureNameSymbol);
+		for (size_t i = 0; i < years.size() && i + 1 < fields.size(); i++)
 		{
-			transform(measureCode.begin(), measureCode.end(), measureCode.begin(), tolower);
-			if (measuresFilter->find(measureCode) == measuresFilter->end())
+			if (filterYears && (years[i] < std::get<0>(*yearsFilter) || years[i] > std::get<1>(*yearsFilter)))
 			{
+				valuesFilteredYear++;
 				continue;
 			}
-		}
 
-		Measure measure = Measure(measureCode, measureName);
-		for (size_t i = 0; i < years.size(); i++)
-		{
-			double value = stod(line.substr(0, line.find(",")));
+			if (fields[i + 1].empty())
+			{
+				continue;
+			}
 
-			if (yearsFilter != nullptr && (std::get<0>(*yearsFilter) != 0 && std::get<1>(*yearsFilter) != 0))
+			double value;
+			if (!parseCSVDouble(fields[i + 1], value))
 			{
-				if (years[i] < std::get<0>(*yearsFilter) || years[i] > std::get<1>(*yearsFilter))
-				{
-					continue;
-				}
+				throw std::runtime_error("Malformed file: invalid value for " + localAuthorityCode +
+										 " in " + std::to_string(years[i]));
 			}
 
 			measure.setValue(years[i], value);
-			line.erase(0, line.find(",") + 1);
 		}
-
-		this->getArea(localAuthorityCode).setMeasure(cols.find(BethYw::SINGLE_MEASURE_CODE)->second, measure);
 	}
+
+	Stats::add(Stats::ROWS_READ, rowsRead);
+	Stats::add(Stats::ROWS_FILTERED_AREA, rowsFilteredArea);
+	Stats::add(Stats::ROWS_FILTERED_YEAR, valuesFilteredYear);
 }
 
 /*
@@ -781,6 +1624,54 @@ void Areas::populate(
 	}
 }
 
+/*
+  As above, but parse the data in the buffer [begin, end), e.g. the contents of
+  an InputMappedFile, rather than a stream. This avoids copying the data
+  through a stream, which matters for the larger datasets.
+
+  @example
+	InputMappedFile input("data/popu1009.json");
+	input.open();
+
+	auto cols = InputFiles::DATASETS["popden"].COLS;
+
+	Areas data = Areas();
+	areas.populate(
+	  input.begin(),
+	  input.end(),
+	  DataType::WelshStatsJSON,
+	  cols,
+	  &areasFilter,
+	  &measuresFilter,
+	  &yearsFilter);
+*/
+void Areas::populate(
+	const char *begin,
+	const char *end,
+	const BethYw::SourceDataType &type,
+	const BethYw::SourceColumnMapping &cols,
+	const StringFilterSet *const areasFilter,
+	const StringFilterSet *const measuresFilter,
+	const YearFilterTuple *const yearsFilter)
+{
+	if (type == BethYw::AuthorityCodeCSV)
+	{
+		populateFromAuthorityCodeCSV(begin, end, cols, areasFilter);
+	}
+	else if (type == BethYw::WelshStatsJSON)
+	{
+		populateFromWelshStatsJSON(begin, end, cols, areasFilter, measuresFilter, yearsFilter);
+	}
+	else if (type == BethYw::AuthorityByYearCSV)
+	{
+		populateFromAuthorityByYearCSV(begin, end, cols, areasFilter, measuresFilter, yearsFilter);
+	}
+	else
+	{
+		throw std::runtime_error("Areas::populate: Unexpected data type");
+	}
+}
+
 /*
   TODO: Areas::toJSON()
 
@@ -856,40 +1747,362 @@ void Areas::populate(
 */
 std::string Areas::toJSON() const
 {
-	if (this->size() == 0)
+	std::ostringstream os;
+	this->writeJSON(os);
+	return os.str();
+}
+
+/*
+  As toJSON(), but write the JSON straight to an output stream as each Area is
+  reached, rather than building the whole document in memory first. The output
+  is the same as dumping the json object described above: keys are in sorted
+  order, an Area (or Measure) with nothing to output is left out, and numbers
+  are formatted by the JSON library. This is the JSON of a view of all the
+  areas (see AreasView).
+
+  @param os
+	The output stream to write the JSON to
+
+  @return
+	void
+
+  @example
+	Areas data = Areas();
+	...
+	data.writeJSON(std::cout);
+*/
+void Areas::writeJSON(std::ostream &os) const
+{
+	AreasView(*this).writeJSON(os);
+}
+
+/*
+  The first bytes of a snapshot file. The trailing number is the version of the
+  format, which must be changed whenever the layout below changes.
+*/
+static const char SNAPSHOT_MAGIC[8] = {'B', 'E', 'T', 'H', 'Y', 'W', 'S', '1'};
+
+/*
+  Written after the magic in native byte order, so a snapshot written on a
+  machine with a different byte order is rejected rather than misread.
+*/
+static const std::uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+/*
+  Bounds on the lengths and counts read from a snapshot, so that a corrupt file
+  is reported as such rather than causing a huge allocation.
+*/
+static const std::uint32_t SNAPSHOT_MAX_LENGTH = 1 << 24;
+
+// Auxiliary functions to write and read the fixed-size values of a snapshot
+template <typename T>
+static void writeSnapshotValue(std::ostream &os, const T value)
+{
+	os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// Auxiliary function to check that count bytes are left to read from the
+// snapshot at pos
+static void checkSnapshotBytes(const char *pos, const char *end, size_t count)
+{
+	if (static_cast<size_t>(end - pos) < count)
 	{
-		return "{}";
+		throw std::runtime_error("Malformed snapshot: unexpected end of file");
 	}
-	json j;
+}
+
+template <typename T>
+static T readSnapshotValue(const char *&pos, const char *end)
+{
+	checkSnapshotBytes(pos, end, sizeof(T));
+
+	T value;
+	std::memcpy(&value, pos, sizeof(T));
+	pos += sizeof(T);
+
+	return value;
+}
+
+static std::uint32_t readSnapshotLength(const char *&pos, const char *end)
+{
+	auto length = readSnapshotValue<std::uint32_t>(pos, end);
+	if (length > SNAPSHOT_MAX_LENGTH)
+	{
+		throw std::runtime_error("Malformed snapshot: invalid length");
+	}
+
+	return length;
+}
+
+/*
+  Write all the Area, and Measure objects within them, to a compact binary
+  snapshot that readSnapshot() can load back without parsing any datasets.
+
+  The snapshot is laid out as (all integers are uint32, in native byte order):
+	magic, byte order marker
+	string table: count, then each string as length followed by its bytes
+	areas: count, then for each area
+	  key, local authority code                      (indexes into the strings)
+	  names: count, then each as language, name      (indexes into the strings)
+	  measures: count, then for each measure
+		key, codename, label                         (indexes into the strings)
+		readings: count, then all the years, then all the values (as doubles)
+
+  Every string (codes, names, labels...) is stored once in the string table, as
+  the same few values are repeated across every area.
+
+  @param os
+	The (binary) output stream to write the snapshot to
+
+  @return
+	void
+
+  @example
+	std::ofstream file("areas.snapshot", std::ios::binary);
+	areas.writeSnapshot(file);
+*/
+void Areas::writeSnapshot(std::ostream &os) const
+{
+	std::vector<const std::string *> strings;
+	std::unordered_map<std::string, std::uint32_t> stringIndexes;
+
+	auto stringIndex = [&](const std::string &str) -> std::uint32_t
+	{
+		auto existing = stringIndexes.find(str);
+		if (existing != stringIndexes.end())
+		{
+			return existing->second;
+		}
+
+		std::uint32_t index = strings.size();
+		auto inserted = stringIndexes.insert(std::make_pair(str, index)).first;
+		strings.push_back(&inserted->first);
+		return index;
+	};
 
-	auto areaCodes = this->getAllAuthorityCodes();
+	// Build the string table and the area records in one pass, then write the
+	// table first so it can be read before the records that refer to it
+	std::vector<std::uint32_t> records;
+	std::vector<const Measure *> measures;
 
-	for (size_t i = 0; i < areaCodes.size(); i++)
+	records.push_back(this->container.size());
+	for (auto it = this->container.begin(); it != this->container.end(); ++it)
 	{
-		auto area = this->container.find(areaCodes[i])->second;
+		const Area &area = it->second;
+		records.push_back(stringIndex(SymbolTable::resolve(it->first)));
+		records.push_back(stringIndex(area.getLocalAuthorityCode()));
+
+		auto langs = area.getAllNames();
+		records.push_back(langs.size());
+		for (auto &lang : langs)
+		{
+			records.push_back(stringIndex(lang));
+			records.push_back(stringIndex(area.getName(lang)));
+		}
+
 		auto measureCodenames = area.getAllMeasureCodenames();
+		records.push_back(measureCodenames.size());
+		for (auto &codename : measureCodenames)
+		{
+			const Measure &measure = area.getMeasure(codename);
+			records.push_back(stringIndex(codename));
+			records.push_back(stringIndex(measure.getCodename()));
+			records.push_back(stringIndex(measure.getLabel()));
+			measures.push_back(&measure);
+		}
+	}
 
-		// Loop through all measures available and push each year + value in json object
-		for (size_t k = 0; k < measureCodenames.size(); k++)
+	os.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	writeSnapshotValue<std::uint32_t>(os, SNAPSHOT_BYTE_ORDER);
+
+	writeSnapshotValue<std::uint32_t>(os, strings.size());
+	for (auto str : strings)
+	{
+		writeSnapshotValue<std::uint32_t>(os, str->size());
+		os.write(str->data(), str->size());
+	}
+
+	// Replay the records, writing each measure's readings after its label
+	size_t record = 0;
+	size_t measure = 0;
+	auto copyRecords = [&](size_t count)
+	{
+		os.write(reinterpret_cast<const char *>(&records[record]), count * sizeof(std::uint32_t));
+		record += count;
+	};
+
+	std::uint32_t numAreas = records[record];
+	copyRecords(1);
+	for (std::uint32_t i = 0; i < numAreas; i++)
+	{
+		copyRecords(2);
+
+		std::uint32_t numNames = records[record];
+		copyRecords(1 + 2 * numNames);
+
+		std::uint32_t numMeasures = records[record];
+		copyRecords(1);
+		for (std::uint32_t k = 0; k < numMeasures; k++)
 		{
-			auto measure = area.getMeasure(measureCodenames[k]);
-			auto years = measure.getAllYears();
+			copyRecords(3);
 
-			for (size_t t = 0; t < years.size(); t++)
+			const Measure &m = *measures[measure++];
+			const Measure::Years &years = m.getAllYears();
+			writeSnapshotValue<std::uint32_t>(os, years.size());
+			for (auto year : years)
+			{
+				writeSnapshotValue<std::uint32_t>(os, year);
+			}
+			for (auto reading : m)
 			{
-				j[areaCodes[i]]["measures"][measureCodenames[k]][std::to_string(years[t])] = measure.getValue(years[t]);
+				writeSnapshotValue<double>(os, reading.value);
 			}
 		}
+	}
+}
+
+/*
+  Load a snapshot written by writeSnapshot() into this Areas object. Each Area
+  in the snapshot is added as if by setArea().
+
+  @param is
+	The (binary) input stream to read the snapshot from
+
+  @return
+	void
+
+  @throws
+	std::runtime_error if the snapshot is malformed, truncated, or was written
+	by a different version of Beth Yw? or on a machine with a different byte
+	order
+
+  @example
+	std::ifstream file("areas.snapshot", std::ios::binary);
+	Areas areas = Areas();
+	areas.readSnapshot(file);
+*/
+void Areas::readSnapshot(std::istream &is)
+{
+	// The snapshot is decoded from a contiguous buffer, so read in the whole
+	// stream
+	std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+	this->readSnapshot(contents.data(), contents.data() + contents.size());
+}
+
+/*
+  As above, but decode the snapshot in the buffer [begin, end), e.g. the
+  contents of an InputMappedFile, rather than a stream. This is how a snapshot
+  is loaded with a single read.
+
+  @example
+	InputMappedFile input("areas.snapshot");
+	input.open();
+
+	Areas areas = Areas();
+	areas.readSnapshot(input.begin(), input.end());
+*/
+void Areas::readSnapshot(const char *begin, const char *end)
+{
+	const char *pos = begin;
+
+	checkSnapshotBytes(pos, end, sizeof(SNAPSHOT_MAGIC));
+	const bool magic = std::equal(pos, pos + sizeof(SNAPSHOT_MAGIC), SNAPSHOT_MAGIC);
+	pos += sizeof(SNAPSHOT_MAGIC);
+
+	if (!magic || readSnapshotValue<std::uint32_t>(pos, end) != SNAPSHOT_BYTE_ORDER)
+	{
+		throw std::runtime_error("Malformed snapshot: not a snapshot from this version of Beth Yw?");
+	}
+
+	// Every string is interned once, and then referred to by its Symbol
+	std::vector<Symbol> symbols(readSnapshotLength(pos, end));
+	std::string str;
+	for (auto &symbol : symbols)
+	{
+		const std::uint32_t length = readSnapshotLength(pos, end);
+		checkSnapshotBytes(pos, end, length);
+
+		str.assign(pos, length);
+		pos += length;
+
+		symbol = SymbolTable::intern(str);
+	}
+
+	auto readSymbol = [&]() -> Symbol
+	{
+		auto index = readSnapshotValue<std::uint32_t>(pos, end);
+		if (index >= symbols.size())
+		{
+			throw std::runtime_error("Malformed snapshot: invalid string index");
+		}
 
-		// Loop through name in the area (i.e. eng and cym) and add the name to json object
-		auto areaNames = area.getAllNames();
-		for (size_t k = 0; k < areaNames.size(); k++)
+		return symbols[index];
+	};
+
+	auto numAreas = readSnapshotLength(pos, end);
+	for (std::uint32_t i = 0; i < numAreas; i++)
+	{
+		Symbol key = readSymbol();
+		Area area(readSymbol(), this->getAllocator());
+
+		auto numNames = readSnapshotLength(pos, end);
+		for (std::uint32_t k = 0; k < numNames; k++)
+		{
+			Symbol lang = readSymbol();
+			area.setName(lang, readSymbol());
+		}
+
+		auto numMeasures = readSnapshotLength(pos, end);
+		for (std::uint32_t k = 0; k < numMeasures; k++)
 		{
-			j[areaCodes[i]]["names"][areaNames[k]] = area.getName(areaNames[k]);
+			Symbol measureKey = readSymbol();
+			Symbol codename = readSymbol();
+			Measure measure(codename, readSymbol(), this->getAllocator());
+
+			// All the years of the readings, and then all their values
+			const std::uint32_t numReadings = readSnapshotLength(pos, end);
+			checkSnapshotBytes(pos, end, numReadings * (sizeof(std::uint32_t) + sizeof(double)));
+
+			const char *values = pos + numReadings * sizeof(std::uint32_t);
+			for (std::uint32_t r = 0; r < numReadings; r++)
+			{
+				const auto year = readSnapshotValue<std::uint32_t>(pos, end);
+				measure.setValue(year, readSnapshotValue<double>(values, end));
+			}
+			pos = values;
+
+			area.setMeasure(measureKey, std::move(measure));
 		}
+
+		this->setArea(key, std::move(area));
+	}
+
+	// A torn or appended-to file must not load as a valid snapshot
+	if (pos != end)
+	{
+		throw std::runtime_error("Malformed snapshot: unexpected data after the last area");
+	}
+}
+
+// Auxiliary method to get all areas sorted alphabetically by their key, as
+// pointers into the container so that neither the keys nor the areas are copied
+std::vector<const AreasContainer::value_type *> Areas::sortedAreas() const
+{
+	std::vector<const AreasContainer::value_type *> sorted;
+	sorted.reserve(this->container.size());
+	for (auto &entry : this->container)
+	{
+		sorted.push_back(&entry);
 	}
 
-	return j.dump();
+	std::sort(sorted.begin(), sorted.end(),
+			  [](const AreasContainer::value_type *a, const AreasContainer::value_type *b) -> bool
+			  {
+				  return SymbolTable::resolve(a->first) < SymbolTable::resolve(b->first);
+			  });
+
+	return sorted;
 }
 
 // Auxiliary method to get all area codes sorted alphabetically
@@ -898,7 +2111,7 @@ const std::vector<std::string> Areas::getAllAuthorityCodes() const noexcept
 	std::vector<std::string> keys;
 	for (auto it = this->container.begin(); it != this->container.end(); ++it)
 	{
-		keys.push_back(it->first);
+		keys.push_back(SymbolTable::resolve(it->first));
 	}
 
 	// Sort keys alphabetically
@@ -910,6 +2123,133 @@ const std::vector<std::string> Areas::getAllAuthorityCodes() const noexcept
 
 	return keys;
 }
+/*
+  Build the indexes of the measures of every area by codename and by year,
+  which getMeasureIndex() and getYearIndex() look up. Code that looks them up
+  should call this once the areas are populated, e.g. before the Areas object
+  is shared between threads, as the lookups only read the indexes. Nothing
+  else builds them, so an import or a query with query() never pays for them.
+
+  The indexes are out of date after any change to the areas, including
+  through the reference returned by the non-const getArea() or by
+  upsertValue(), and this must be called again before they are next used. A
+  reference kept from either must not be used to change the Area after the
+  indexes are built.
+
+  @return
+	void
+
+  @example
+	Areas data = Areas();
+	...
+	data.buildIndexes();
+*/
+void Areas::buildIndexes()
+{
+	this->measureIndex.clear();
+	this->yearIndex.clear();
+
+	for (auto entry : this->sortedAreas())
+	{
+		const AreaView area(entry->second);
+
+		for (auto &measure : area.getMeasures())
+		{
+			const Measure &indexed = measure.second.getMeasure();
+			const IndexEntry indexEntry = {entry->first, measure.first, &indexed};
+
+			this->measureIndex[measure.first].push_back(indexEntry);
+
+			for (auto year : indexed.getAllYears())
+			{
+				this->yearIndex[year].push_back(indexEntry);
+			}
+		}
+	}
+
+	this->indexed = true;
+}
+
+// Auxiliary method to check that the indexes are up to date before they are
+// looked up, as a lookup never builds them
+static void checkIndexed(bool indexed)
+{
+	if (!indexed)
+	{
+		throw std::logic_error("The indexes of the areas are out of date: call buildIndexes() first");
+	}
+}
+
+/*
+  Find the Measure with a codename in every Area that has one, without
+  walking all the areas.
+
+  @param codename
+	The codename of the Measure, in any case
+
+  @return
+	The Area and Measure of each, in order of local authority code, which is
+	empty if no Area has such a Measure
+
+  @throws
+	std::logic_error if the indexes have not been built since the areas were
+	last changed (see buildIndexes())
+
+  @example
+	data.buildIndexes();
+	for (auto &entry : data.getMeasureIndex("pop")) {
+	  std::cout << SymbolTable::resolve(entry.localAuthorityCode) << ": "
+	            << entry.measure->getAverage() << std::endl;
+	}
+*/
+const Areas::Index &Areas::getMeasureIndex(const std::string &codename) const
+{
+	static const Index none;
+
+	checkIndexed(this->indexed);
+
+	Symbol key;
+	if (!SymbolTable::findFolded(codename, key))
+	{
+		return none;
+	}
+
+	auto found = this->measureIndex.find(key);
+	return found == this->measureIndex.end() ? none : found->second;
+}
+
+/*
+  Find every Measure, in any Area, that has a value for a year, without
+  walking all the areas.
+
+  @param year
+	The year to find the measures with a value for
+
+  @return
+	The Area and Measure of each, in order of local authority code and then
+	codename, which is empty if no Measure has a value for the year
+
+  @throws
+	std::logic_error if the indexes have not been built since the areas were
+	last changed (see buildIndexes())
+
+  @example
+	data.buildIndexes();
+	for (auto &entry : data.getYearIndex(2015)) {
+	  std::cout << entry.measure->getLabel() << ": "
+	            << entry.measure->getValue(2015) << std::endl;
+	}
+*/
+const Areas::Index &Areas::getYearIndex(unsigned int year) const
+{
+	static const Index none;
+
+	checkIndexed(this->indexed);
+
+	auto found = this->yearIndex.find(year);
+	return found == this->yearIndex.end() ? none : found->second;
+}
+
 /*
   TODO: operator<<(os, areas)
 
@@ -1016,51 +2356,29 @@ const std::vector<std::string> Areas::getAllAuthorityCodes() const noexcept
 	Areas areas();
 	std::cout << areas << std::end;
 */
-std::ostream &operator<<(std::ostream &os, Areas &areas)
+std::ostream &operator<<(std::ostream &os, const Areas &areas)
 {
-
-	auto areaCodes = areas.getAllAuthorityCodes();
-
-	for (size_t i = 0; i < areaCodes.size(); i++)
-	{
-		auto area = areas.getArea(areaCodes[i]);
-		os << area;
-	}
-
-	return os;
+	return os << AreasView(areas);
 }
 
 // Auxiliary method to search for anything that matches in area filter.
 // This searches substrings of the filter to implement the extended argument filtering functionality (Task 8 in assignment brief)
 // searchStrs is vector that contains the strings you want to apply the search on. For example apply search on area code, english name and welsh name
+// This compiles the filter each time it is called, so the parsers above build an AreaFilterMatcher once instead
 bool searchStrInAreasFilter(const StringFilterSet *const areasFilter, const std::vector<std::string> &searchStrs)
 {
-	// If filter is null or empty, import everything (i.e. return true)
-	if (areasFilter == nullptr || areasFilter->empty())
-	{
-		return true;
-	}
+	const AreaFilterMatcher matcher(areasFilter);
 
-	std::vector<std::string> values;
-	for (size_t i = 0; i < searchStrs.size(); i++)
+	if (matcher.matchesAll())
 	{
-		values.push_back(searchStrs[i].c_str());
-		std::transform(values[i].begin(), values[i].end(), values[i].begin(), tolower);
+		return true;
 	}
 
-	// For every filter string search for a match in the substring
-	// in one of the values in searchStrs
-	for (auto &areaString : *areasFilter)
+	for (auto &str : searchStrs)
 	{
-		std::string areasStringLower = areaString.c_str();
-		std::transform(areasStringLower.begin(), areasStringLower.end(), areasStringLower.begin(), tolower);
-
-		for (auto value : values)
+		if (matcher.matches(str))
 		{
-			if (value.find(areasStringLower) != std::string::npos)
-			{
-				return true;
-			}
+			return true;
 		}
 	}
 
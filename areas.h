@@ -27,13 +27,19 @@
  */
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "datasets.h"
+#include "arena.h"
 #include "area.h"
 
+class AreasView;
+
 /*
   An alias for filters based on strings such as categorisations e.g. area,
   and measures.
@@ -52,7 +58,11 @@ using YearFilterTuple = std::tuple<unsigned int, unsigned int>;
   AreasContainer to a valid Standard Library container of your choosing.
 */
 
-using AreasContainer = std::unordered_map<std::string, Area>;
+using AreasContainer = std::unordered_map<Symbol,
+										  Area,
+										  std::hash<Symbol>,
+										  std::equal_to<Symbol>,
+										  ArenaAllocator<std::pair<const Symbol, Area>>>;
 
 /*
   Areas is a class that stores all the data categorised by area. The
@@ -70,16 +80,90 @@ using AreasContainer = std::unordered_map<std::string, Area>;
 */
 class Areas
 {
+public:
+	/*
+	  A Measure of an Area, as found in the indexes of an Areas object: the
+	  local authority code the Area is stored under, the (lowercase) codename
+	  the Measure is stored under in the Area, and the Measure.
+	*/
+	struct IndexEntry
+	{
+		Symbol localAuthorityCode;
+		Symbol codename;
+		const Measure *measure;
+	};
+
+	/*
+	  The entries of an index for a codename or year, in order of local
+	  authority code and then codename.
+	*/
+	using Index = std::vector<IndexEntry>;
+
 private:
+	// Everything in container (and the Area and Measure objects in it) is
+	// allocated from arena, so it must be declared first to be destroyed last
+	std::unique_ptr<Arena> arena;
+
 	AreasContainer container;
 
+	// Maps the Symbol of each lowercased local authority code to its key in
+	// container, so case-insensitive lookups are a hash lookup rather than a
+	// scan
+	std::unordered_map<Symbol,
+					   Symbol,
+					   std::hash<Symbol>,
+					   std::equal_to<Symbol>,
+					   ArenaAllocator<std::pair<const Symbol, Symbol>>>
+		authorityIndex;
+
+	std::vector<const AreasContainer::value_type *> sortedAreas() const;
+	Area &upsertArea(Symbol localAuthorityCode);
+
+	// The measures of every area by codename (keyed on the Symbol of the
+	// lowercase codename) and by each year they have a value for. These are
+	// built once the areas are populated (see buildIndexes()), and any later
+	// change to the areas marks them as out of date, so that importing does
+	// not pay to keep them up to date
+	std::unordered_map<Symbol, Index> measureIndex;
+	std::unordered_map<unsigned int, Index> yearIndex;
+	bool indexed = false;
+
+	// Views select from the container without copying it
+	friend class AreasView;
+
 public:
 	Areas();
+	Areas(const Areas &other);
+	Areas(Areas &&other);
+	Areas &operator=(Areas other);
+	void swap(Areas &other) noexcept;
+
+	Area::allocator_type getAllocator() const noexcept;
+
 	void setArea(const std::string localAuthorityCode, Area area);
+	void setArea(Symbol localAuthorityCode, Area area);
 	Area &getArea(const std::string &localAuthorityCode);
+	const Area &getArea(const std::string &localAuthorityCode) const;
+	Area &upsertValue(const std::string &localAuthorityCode,
+					  const std::string &codename,
+					  const std::string &label,
+					  unsigned int year,
+					  double value);
+	Area &upsertValue(Symbol localAuthorityCode, Symbol codename, Symbol label, unsigned int year, double value);
+	void merge(Areas &&other);
+	AreasView query(const StringFilterSet *const areasFilter,
+					const StringFilterSet *const measuresFilter,
+					const YearFilterTuple *const yearsFilter) const;
+	Areas select(const StringFilterSet *const areasFilter,
+				 const StringFilterSet *const measuresFilter,
+				 const YearFilterTuple *const yearsFilter) const;
 
 	const std::vector<std::string> getAllAuthorityCodes() const noexcept;
 
+	void buildIndexes();
+	const Index &getMeasureIndex(const std::string &codename) const;
+	const Index &getYearIndex(unsigned int year) const;
+
 	const int size() const;
 
 	void populateFromAuthorityCodeCSV(
@@ -87,12 +171,25 @@ public:
 		const BethYw::SourceColumnMapping &cols,
 		const StringFilterSet *const areas = nullptr) noexcept(false);
 
+	void populateFromAuthorityCodeCSV(
+		const char *begin,
+		const char *end,
+		const BethYw::SourceColumnMapping &cols,
+		const StringFilterSet *const areas = nullptr) noexcept(false);
+
 	void populateFromWelshStatsJSON(std::istream &is,
 									const BethYw::SourceColumnMapping &cols,
 									const StringFilterSet *const areasFilter,
 									const StringFilterSet *const measuresFilter,
 									const YearFilterTuple *const yearsFilter);
 
+	void populateFromWelshStatsJSON(const char *begin,
+									const char *end,
+									const BethYw::SourceColumnMapping &cols,
+									const StringFilterSet *const areasFilter,
+									const StringFilterSet *const measuresFilter,
+									const YearFilterTuple *const yearsFilter);
+
 	void populateFromAuthorityByYearCSV(
 		std::istream &is,
 		const BethYw::SourceColumnMapping &cols,
@@ -100,6 +197,14 @@ public:
 		const StringFilterSet *const measuresFilter,
 		const YearFilterTuple *const yearsFilter);
 
+	void populateFromAuthorityByYearCSV(
+		const char *begin,
+		const char *end,
+		const BethYw::SourceColumnMapping &cols,
+		const StringFilterSet *const areasFilter,
+		const StringFilterSet *const measuresFilter,
+		const YearFilterTuple *const yearsFilter);
+
 	void populate(
 		std::istream &is,
 		const BethYw::SourceDataType &type,
@@ -113,9 +218,23 @@ public:
 		const StringFilterSet *const measuresFilter = nullptr,
 		const YearFilterTuple *const yearsFilter = nullptr) noexcept(false);
 
+	void populate(
+		const char *begin,
+		const char *end,
+		const BethYw::SourceDataType &type,
+		const BethYw::SourceColumnMapping &cols,
+		const StringFilterSet *const areasFilter = nullptr,
+		const StringFilterSet *const measuresFilter = nullptr,
+		const YearFilterTuple *const yearsFilter = nullptr) noexcept(false);
+
 	std::string toJSON() const;
+	void writeJSON(std::ostream &os) const;
+
+	void writeSnapshot(std::ostream &os) const;
+	void readSnapshot(std::istream &is) noexcept(false);
+	void readSnapshot(const char *begin, const char *end) noexcept(false);
 
-	friend std::ostream &operator<<(std::ostream &os, Areas &areas);
+	friend std::ostream &operator<<(std::ostream &os, const Areas &areas);
 };
 
 bool searchStrInAreasFilter(const StringFilterSet *const areasFilter, const std::vector<std::string> &searchStrs);
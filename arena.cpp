@@ -0,0 +1,160 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the implementation of Arena. See the header file for
+  additional comments.
+ */
+
+#include <cstdint>
+
+#include "arena.h"
+
+// The first block is small, so that an empty Areas object costs little, and
+// each block after that is twice the size of the last, up to a limit
+static const std::size_t FIRST_BLOCK_SIZE = 4096;
+static const std::size_t MAX_BLOCK_SIZE = 1 << 20;
+
+/*
+  Constructor for an empty Arena. No memory is allocated until the first call
+  to allocate().
+
+  @example
+	Arena arena;
+	ArenaAllocator<int> alloc(&arena);
+	std::vector<int, ArenaAllocator<int>> numbers(alloc);
+*/
+Arena::Arena() noexcept : nextBlockSize(FIRST_BLOCK_SIZE) {}
+
+/*
+  Destructor for an Arena, which releases all the memory allocated from it at
+  once. Anything allocated from the Arena must have been destroyed already.
+*/
+Arena::~Arena()
+{
+	while (this->blocks != nullptr)
+	{
+		Block *previous = this->blocks->previous;
+		::operator delete(this->blocks);
+		this->blocks = previous;
+	}
+}
+
+/*
+  Allocate memory from the Arena.
+
+  @param bytes
+	The number of bytes to allocate
+
+  @param alignment
+	The alignment of the memory, which must be a power of two no greater than
+	that of std::max_align_t
+
+  @return
+	A pointer to the memory, which stays valid until the Arena is destroyed
+
+  @throws
+	std::bad_alloc if a new block cannot be allocated
+
+  @example
+	Arena arena;
+	auto numbers = static_cast<int *>(arena.allocate(10 * sizeof(int), alignof(int)));
+*/
+void *Arena::allocate(std::size_t bytes, std::size_t alignment)
+{
+	// Reuse a freed allocation of the same size class, if there is one
+	if (bytes <= MAX_CLASS_SIZE && alignment <= CLASS_SIZE)
+	{
+		bytes = bytes == 0 ? CLASS_SIZE : (bytes + CLASS_SIZE - 1) & ~(CLASS_SIZE - 1);
+		alignment = CLASS_SIZE;
+
+		FreeChunk *&chunks = this->freeChunks[bytes / CLASS_SIZE - 1];
+		if (chunks != nullptr)
+		{
+			FreeChunk *chunk = chunks;
+			chunks = chunk->next;
+			return chunk;
+		}
+	}
+
+	auto address = reinterpret_cast<std::uintptr_t>(this->pos);
+	auto aligned = reinterpret_cast<char *>((address + alignment - 1) & ~(alignment - 1));
+
+	if (this->pos == nullptr || aligned > this->end || static_cast<std::size_t>(this->end - aligned) < bytes)
+	{
+		return this->allocateBlock(bytes, alignment);
+	}
+
+	this->pos = aligned + bytes;
+	return aligned;
+}
+
+// Auxiliary method to start a new block large enough for an allocation that
+// does not fit in the current one, and allocate from it
+void *Arena::allocateBlock(std::size_t bytes, std::size_t alignment)
+{
+	const std::size_t header = alignof(std::max_align_t) > sizeof(Block) ? alignof(std::max_align_t) : sizeof(Block);
+	std::size_t size = this->nextBlockSize;
+
+	if (size < header + bytes + alignment)
+	{
+		size = header + bytes + alignment;
+	}
+
+	auto block = static_cast<Block *>(::operator new(size));
+	block->previous = this->blocks;
+	this->blocks = block;
+
+	this->pos = reinterpret_cast<char *>(block) + header;
+	this->end = reinterpret_cast<char *>(block) + size;
+
+	if (this->nextBlockSize < MAX_BLOCK_SIZE)
+	{
+		this->nextBlockSize *= 2;
+	}
+
+	return this->allocate(bytes, alignment);
+}
+
+/*
+  Return memory to the Arena. If it was the most recent allocation (e.g. a map
+  node that was freed straight away because its key was already in the map) it
+  is reused by the next allocation. Otherwise a small allocation (e.g. the old
+  buffer of a Measure's readings, after they have grown) is reused by the next
+  allocation of the same size class, and a large one is released with the rest
+  of the Arena.
+
+  @param p
+	A pointer returned by allocate()
+
+  @param bytes
+	The number of bytes that were allocated
+
+  @param alignment
+	The alignment the memory was allocated with
+*/
+void Arena::deallocate(void *p, std::size_t bytes, std::size_t alignment) noexcept
+{
+	const bool sized = bytes <= MAX_CLASS_SIZE && alignment <= CLASS_SIZE;
+	if (sized)
+	{
+		bytes = bytes == 0 ? CLASS_SIZE : (bytes + CLASS_SIZE - 1) & ~(CLASS_SIZE - 1);
+	}
+
+	if (static_cast<char *>(p) + bytes == this->pos)
+	{
+		this->pos = static_cast<char *>(p);
+	}
+	else if (sized)
+	{
+		FreeChunk *chunk = static_cast<FreeChunk *>(p);
+		FreeChunk *&chunks = this->freeChunks[bytes / CLASS_SIZE - 1];
+		chunk->next = chunks;
+		chunks = chunk;
+	}
+}
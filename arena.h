@@ -0,0 +1,154 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the declarations of Arena, a monotonic memory arena, and
+  ArenaAllocator, a Standard Library allocator that allocates from one.
+
+  An Areas object is built once from the datasets and then freed all at once,
+  and is made of thousands of small allocations: the nodes of the maps in each
+  Area and the readings of each Measure. Each Areas object therefore owns an
+  Arena, and its containers (and those of the Area and Measure objects in it)
+  allocate from it with an ArenaAllocator. Allocating is then bumping a
+  pointer, and freeing is releasing a few large blocks.
+
+  The readings of a Measure grow as they are imported, and each time they do
+  the old buffer is freed. Small allocations are therefore rounded up to a size
+  class, and once freed are kept on a list for that class to be reused by the
+  next allocation of the same class, rather than being stranded in the Arena.
+
+  An ArenaAllocator that is default-constructed (i.e. without an Arena) uses
+  the heap, so Area and Measure objects that are created on their own behave
+  just as before. Copying a container gives the copy a default (heap)
+  allocator, so a copy never refers to an Arena that it might outlive. Moving
+  a container takes its allocator with it, so an Area or Measure moved out of
+  an Areas object must not outlive it (see Area(Area &&other)).
+ */
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+/*
+  A monotonic arena: memory is allocated from large blocks and only released
+  when the Arena is destroyed, although freed small allocations are reused. An
+  Arena is not thread-safe, and so each Areas object (e.g. each one importing
+  a dataset on a different thread) has its own.
+*/
+class Arena
+{
+private:
+	// Each block starts with a header that links it to the previous block
+	struct Block
+	{
+		Block *previous;
+	};
+
+	Block *blocks = nullptr;
+	char *pos = nullptr;
+	char *end = nullptr;
+	std::size_t nextBlockSize;
+
+	// Allocations of up to MAX_CLASS_SIZE bytes are rounded up to a multiple
+	// of CLASS_SIZE (and aligned to it), and when freed are linked into the
+	// list for their size
+	static const std::size_t CLASS_SIZE = 16;
+	static const std::size_t MAX_CLASS_SIZE = 1024;
+
+	struct FreeChunk
+	{
+		FreeChunk *next;
+	};
+
+	FreeChunk *freeChunks[MAX_CLASS_SIZE / CLASS_SIZE] = {};
+
+	void *allocateBlock(std::size_t bytes, std::size_t alignment);
+
+public:
+	Arena() noexcept;
+	~Arena();
+
+	Arena(const Arena &other) = delete;
+	Arena &operator=(const Arena &other) = delete;
+
+	void *allocate(std::size_t bytes, std::size_t alignment);
+	void deallocate(void *p, std::size_t bytes, std::size_t alignment) noexcept;
+};
+
+/*
+  A Standard Library allocator that allocates from an Arena, or from the heap if
+  it has no Arena.
+*/
+template <typename T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+
+	// Containers that are moved or swapped take their allocator with them,
+	// but a container that is copied over keeps its own
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	Arena *arena;
+
+	ArenaAllocator() noexcept : arena(nullptr) {}
+	ArenaAllocator(Arena *arena) noexcept : arena(arena) {}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other) noexcept : arena(other.arena) {}
+
+	T *allocate(std::size_t n)
+	{
+		if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+		{
+			throw std::bad_alloc();
+		}
+
+		if (this->arena == nullptr)
+		{
+			return static_cast<T *>(::operator new(n * sizeof(T)));
+		}
+
+		return static_cast<T *>(this->arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T *p, std::size_t n) noexcept
+	{
+		if (this->arena == nullptr)
+		{
+			::operator delete(p);
+			return;
+		}
+
+		this->arena->deallocate(p, n * sizeof(T), alignof(T));
+	}
+
+	// A copy of a container allocates from the heap
+	ArenaAllocator select_on_container_copy_construction() const noexcept
+	{
+		return ArenaAllocator();
+	}
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) noexcept
+{
+	return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) noexcept
+{
+	return a.arena != b.arena;
+}
+
+#endif // ARENA_H_
@@ -0,0 +1,66 @@
+#ifndef BENCHMARKS_ALLOCATIONS_H_
+#define BENCHMARKS_ALLOCATIONS_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Replaces global operator new and delete to count the heap allocations (and
+  frees) made by the code being benchmarked, e.g.
+
+	size_t before = allocations;
+	areas.populate(...);
+	std::cout << allocations - before << " allocations" << std::endl;
+
+  The replacements must be defined once in a program, so this is included by
+  each benchmark that counts allocations rather than compiled on its own, and
+  the include guard keeps benchall.cpp (which includes every benchmark) to one.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// GCC 11+ sees the malloc() in operator new inlined at each new expression and
+// warns that the matching delete frees it with operator delete, which is the
+// point of replacing both
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<std::size_t> allocations(0);
+static std::atomic<std::size_t> frees(0);
+
+void *operator new(std::size_t size)
+{
+	allocations++;
+
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return p;
+}
+
+void operator delete(void *p) noexcept
+{
+	if (p != nullptr)
+	{
+		frees++;
+	}
+
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	::operator delete(p);
+}
+
+#endif // BENCHMARKS_ALLOCATIONS_H_
@@ -0,0 +1,79 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 benchmark script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+
+  Measures how importing a WelshStatsJSON file scales with the number of
+  distinct local authorities in it. Every row of the file is merged into the
+  Areas container with Areas::setArea(), so if finding an existing Area was
+  not a constant-time lookup the times below would grow quadratically rather
+  than linearly with the number of authorities.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+
+#include "../datasets.h"
+#include "../areas.h"
+
+// Build a popu1009.json-like document with a row for each of two measures
+// over two years for `authorities` synthetic local authority codes
+static std::string syntheticWelshStatsJSON(unsigned int authorities)
+{
+	std::ostringstream os;
+	const char *measures[] = {"Pop", "Dens"};
+
+	os << "{\"odata.metadata\":\"synthetic\",\"value\":[";
+	for (unsigned int i = 0; i < authorities; i++)
+	{
+		for (auto measure : measures)
+		{
+			for (unsigned int year = 2000; year < 2002; year++)
+			{
+				if (i != 0 || measure != measures[0] || year != 2000)
+				{
+					os << ",";
+				}
+
+				os << "{\"Localauthority_Code\":\"X" << (10000000 + i) << "\","
+				   << "\"Localauthority_ItemName_ENG\":\"Authority " << i << "\","
+				   << "\"Measure_Code\":\"" << measure << "\","
+				   << "\"Measure_ItemName_ENG\":\"" << measure << "\","
+				   << "\"Year_Code\":\"" << year << "\","
+				   << "\"Data\":\"" << (i + year) << ".5\"}";
+			}
+		}
+	}
+	os << "]}";
+
+	return os.str();
+}
+
+TEST_CASE("WelshStatsJSON import scales linearly with the number of authorities", "[benchmark][Areas]")
+{
+	const auto &cols = BethYw::InputFiles::POPDEN.COLS;
+	const unsigned int sizes[] = {1000, 2000, 4000, 8000};
+
+	for (auto size : sizes)
+	{
+		const std::string json = syntheticWelshStatsJSON(size);
+
+		BENCHMARK(std::to_string(size) + " authorities")
+		{
+			std::istringstream is(json);
+			Areas areas = Areas();
+			areas.populateFromWelshStatsJSON(is, cols, nullptr, nullptr, nullptr);
+			return areas.size();
+		};
+	}
+}
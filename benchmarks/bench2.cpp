@@ -0,0 +1,132 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 benchmark script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+
+  Compares the throughput of the scalar and vectorised (SSE2, or AVX2 when
+  built with -DBETHYW_NATIVE=ON on a CPU that has it) CSV scanning kernels
+  in csv.cpp, and of the CSVReader built on them, on a numeric
+  AuthorityByYearCSV-style table and on a table with long text fields like
+  areas.csv.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../lib_catch.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../csv.h"
+
+// Build roughly `bytes` of CSV where each record has an authority code and
+// `columns` fields of `fieldWidth` characters
+static std::string syntheticCSV(size_t bytes, unsigned int columns, unsigned int fieldWidth)
+{
+	std::string csv;
+	csv.reserve(bytes + 1024);
+
+	for (unsigned int row = 0; csv.size() < bytes; row++)
+	{
+		csv += "W" + std::to_string(10000000 + row);
+		for (unsigned int i = 0; i < columns; i++)
+		{
+			csv += ',';
+			csv += std::string(fieldWidth, static_cast<char>('a' + (row + i) % 26));
+		}
+		csv += "\r\n";
+	}
+
+	return csv;
+}
+
+// Count the significant characters in csv with the given kernel
+template <typename Kernel>
+static size_t countSpecials(const std::string &csv, Kernel kernel)
+{
+	size_t count = 0;
+	const char *end = csv.data() + csv.size();
+
+	for (const char *c = kernel(csv.data(), end); c != end; c = kernel(c + 1, end))
+	{
+		count++;
+	}
+
+	return count;
+}
+
+// Run fn repeatedly for at least a quarter of a second and print its
+// throughput over `bytes` of input in MB/s
+template <typename F>
+static void reportThroughput(const std::string &name, size_t bytes, F fn)
+{
+	using clock = std::chrono::steady_clock;
+	size_t runs = 0;
+	auto start = clock::now();
+	std::chrono::duration<double> elapsed;
+
+	do
+	{
+		volatile size_t result = fn();
+		(void)result;
+		runs++;
+		elapsed = clock::now() - start;
+	} while (elapsed.count() < 0.25);
+
+	std::cout << name << ": " << (bytes * runs / 1e6) / elapsed.count() << " MB/s" << std::endl;
+}
+
+TEST_CASE("CSV scanning kernels: scalar vs vectorised throughput", "[benchmark][CSV]")
+{
+	const size_t size = 16 * 1000 * 1000;
+
+	struct
+	{
+		const char *name;
+		std::string csv;
+	} inputs[] = {{"numeric fields (8 bytes)", syntheticCSV(size, 11, 8)},
+				  {"text fields (48 bytes)", syntheticCSV(size, 2, 48)}};
+
+	for (auto &input : inputs)
+	{
+		const std::string &csv = input.csv;
+		const std::string name = input.name;
+
+		REQUIRE(countSpecials(csv, findCSVSpecial) == countSpecials(csv, findCSVSpecialScalar));
+
+		reportThroughput("findCSVSpecialScalar, " + name, csv.size(), [&]()
+						 { return countSpecials(csv, findCSVSpecialScalar); });
+		reportThroughput("findCSVSpecial, " + name, csv.size(), [&]()
+						 { return countSpecials(csv, findCSVSpecial); });
+		reportThroughput("CSVReader, " + name, csv.size(), [&]()
+						 {
+							 CSVReader reader(csv.data(), csv.data() + csv.size());
+							 std::vector<CSVField> fields;
+							 size_t records = 0;
+							 while (reader.next(fields))
+							 {
+								 records++;
+							 }
+							 return records;
+						 });
+
+		BENCHMARK("findCSVSpecialScalar, " + name)
+		{
+			return countSpecials(csv, findCSVSpecialScalar);
+		};
+
+		BENCHMARK("findCSVSpecial, " + name)
+		{
+			return countSpecials(csv, findCSVSpecial);
+		};
+	}
+}
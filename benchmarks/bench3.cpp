@@ -0,0 +1,69 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 benchmark script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+
+  Measures the text table output of operator<< for Areas, i.e. the default
+  output of bethyw, for synthetic areas with a number of measures over a number
+  of years. The tables are written to a string stream, so the times are of the
+  formatting alone and not of writing to a terminal or file.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+
+#include "../areas.h"
+
+// Build `authorities` synthetic areas, each with `measures` measures that have
+// a value for each of `years` years
+static Areas syntheticAreas(unsigned int authorities, unsigned int measures, unsigned int years)
+{
+	Areas areas = Areas();
+
+	for (unsigned int i = 0; i < authorities; i++)
+	{
+		const std::string code = "X" + std::to_string(10000000 + i);
+		Area area(code);
+		area.setName("eng", "Authority " + std::to_string(i));
+		area.setName("cym", "Awdurdod " + std::to_string(i));
+
+		for (unsigned int m = 0; m < measures; m++)
+		{
+			Measure measure("m" + std::to_string(m), "Measure " + std::to_string(m));
+			for (unsigned int year = 2000; year < 2000 + years; year++)
+			{
+				measure.setValue(year, (i + 1) * 1234.5678 + m * year);
+			}
+			area.setMeasure(measure.getCodename(), measure);
+		}
+
+		areas.setArea(code, area);
+	}
+
+	return areas;
+}
+
+TEST_CASE("Table output of Areas", "[benchmark][Areas]")
+{
+	const unsigned int sizes[] = {100, 1000};
+
+	for (auto size : sizes)
+	{
+		const Areas areas = syntheticAreas(size, 4, 20);
+
+		BENCHMARK(std::to_string(size) + " authorities, 4 measures, 20 years")
+		{
+			std::ostringstream os;
+			os << areas;
+			return os.str().size();
+		};
+	}
+}
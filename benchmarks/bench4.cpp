@@ -0,0 +1,150 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 benchmark script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+
+  Compares building and tearing down the same areas, measures and readings
+  with every container allocating from the heap (as before Areas owned an
+  Arena) and with them allocating from the Arena of an Areas object, counting
+  the heap allocations of each (see allocations.h).
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../lib_catch.hpp"
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../areas.h"
+#include "allocations.h"
+
+static const unsigned int AUTHORITIES = 2000;
+static const unsigned int MEASURES = 4;
+static const unsigned int YEARS = 20;
+
+// The codes, names and codenames are interned up front, as both variants share
+// the same (global) symbol table
+struct SyntheticSymbols
+{
+	std::vector<Symbol> codes;
+	std::vector<Symbol> names;
+	std::vector<Symbol> measures;
+	Symbol eng = SymbolTable::intern("eng");
+
+	SyntheticSymbols()
+	{
+		for (unsigned int i = 0; i < AUTHORITIES; i++)
+		{
+			codes.push_back(SymbolTable::intern("X" + std::to_string(10000000 + i)));
+			names.push_back(SymbolTable::intern("Authority " + std::to_string(i)));
+		}
+
+		for (unsigned int m = 0; m < MEASURES; m++)
+		{
+			measures.push_back(SymbolTable::intern("m" + std::to_string(m)));
+		}
+	}
+};
+
+// Build an Area of synthetic data with the given allocator
+static Area syntheticArea(const SyntheticSymbols &symbols, unsigned int i, const Area::allocator_type &alloc)
+{
+	Area area(symbols.codes[i], alloc);
+	area.setName(symbols.eng, symbols.names[i]);
+
+	for (unsigned int m = 0; m < MEASURES; m++)
+	{
+		Measure measure(symbols.measures[m], symbols.measures[m], alloc);
+		for (unsigned int year = 2000; year < 2000 + YEARS; year++)
+		{
+			measure.setValue(year, i * 0.5 + year);
+		}
+		area.setMeasure(symbols.measures[m], std::move(measure));
+	}
+
+	return area;
+}
+
+// The containers of Areas, allocating from the heap
+struct HeapAreas
+{
+	std::unordered_map<Symbol, Area> container;
+	std::unordered_map<Symbol, Symbol> authorityIndex;
+};
+
+static void buildHeap(HeapAreas &areas, const SyntheticSymbols &symbols)
+{
+	for (unsigned int i = 0; i < AUTHORITIES; i++)
+	{
+		areas.container.emplace(symbols.codes[i], syntheticArea(symbols, i, Area::allocator_type()));
+		areas.authorityIndex.emplace(SymbolTable::fold(symbols.codes[i]), symbols.codes[i]);
+	}
+}
+
+static void buildArena(Areas &areas, const SyntheticSymbols &symbols)
+{
+	for (unsigned int i = 0; i < AUTHORITIES; i++)
+	{
+		areas.setArea(symbols.codes[i], syntheticArea(symbols, i, areas.getAllocator()));
+	}
+}
+
+TEST_CASE("Heap allocations of building and freeing Areas", "[benchmark][Areas][Arena]")
+{
+	const SyntheticSymbols symbols;
+
+	size_t heapLoad, heapTeardown, arenaLoad, arenaTeardown;
+	{
+		size_t before = allocations;
+		auto heap = new HeapAreas();
+		buildHeap(*heap, symbols);
+		heapLoad = allocations - before;
+
+		before = frees;
+		delete heap;
+		heapTeardown = frees - before;
+	}
+	{
+		size_t before = allocations;
+		auto arena = new Areas();
+		buildArena(*arena, symbols);
+		arenaLoad = allocations - before;
+
+		before = frees;
+		delete arena;
+		arenaTeardown = frees - before;
+	}
+
+	std::cout << AUTHORITIES << " authorities, " << MEASURES << " measures, " << YEARS << " years:" << std::endl
+			  << "  heap:  " << heapLoad << " allocations to build, " << heapTeardown << " frees to tear down" << std::endl
+			  << "  arena: " << arenaLoad << " allocations to build, " << arenaTeardown << " frees to tear down" << std::endl;
+
+	BENCHMARK_ADVANCED("build and free on the heap")(Catch::Benchmark::Chronometer meter)
+	{
+		std::vector<HeapAreas> areas(meter.runs());
+		meter.measure([&](int i)
+					  {
+						  buildHeap(areas[i], symbols);
+						  HeapAreas().container.swap(areas[i].container);
+						  return areas[i].container.size();
+					  });
+	};
+
+	BENCHMARK_ADVANCED("build and free in an Arena")(Catch::Benchmark::Chronometer meter)
+	{
+		std::vector<Areas> areas(meter.runs());
+		meter.measure([&](int i)
+					  {
+						  buildArena(areas[i], symbols);
+						  Areas().swap(areas[i]);
+						  return areas[i].size();
+					  });
+	};
+}
@@ -0,0 +1,495 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 benchmark script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+
+  The benchmark suite for regressions: every import, query and export path of
+  Areas, on the bundled datasets and on synthetic datasets (see generator.h)
+  scaled up to many more authorities. For each path, the throughput in rows/s
+  (or values/s) and MB/s, and the heap allocations per run (see
+  allocations.h), are printed before Catch2's own timings.
+
+  This must be run from the root of the repository, so that datasets/ can be
+  found, e.g.
+	./build.sh benchall && ./bin/bethyw-bench "[suite]"
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../lib_catch.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../csv.h"
+#include "../datasets.h"
+#include "../areas.h"
+#include "../generator.h"
+#include "../view.h"
+#include "allocations.h"
+
+// A dataset to import: where its columns come from, its contents and how many
+// rows of data (e.g. records of CSV or objects in value[]) it has
+struct SuiteInput
+{
+	std::string name;
+	const BethYw::InputFileSource &source;
+	std::string contents;
+	size_t rows;
+};
+
+// Read a bundled dataset into memory
+static std::string readSuiteDataset(const std::string &file)
+{
+	std::ifstream is("datasets/" + file, std::ios::binary);
+	if (!is)
+	{
+		throw std::runtime_error("Cannot open datasets/" + file + " (run from the root of the repository)");
+	}
+
+	std::ostringstream contents;
+	contents << is.rdbuf();
+	return contents.str();
+}
+
+// Count the rows of data in a dataset: the records after the headings of a
+// CSV file, or the rows in value[] of a WelshStatsJSON file (each of which
+// has the authority code column once)
+static size_t countSuiteRows(const std::string &contents, const BethYw::InputFileSource &source)
+{
+	size_t rows = 0;
+
+	if (source.PARSER == BethYw::WelshStatsJSON)
+	{
+		const std::string key = "\"" + source.COLS.at(BethYw::AUTH_CODE) + "\"";
+		for (size_t pos = contents.find(key); pos != std::string::npos; pos = contents.find(key, pos + 1))
+		{
+			rows++;
+		}
+
+		return rows;
+	}
+
+	CSVReader reader(contents.data(), contents.data() + contents.size());
+	std::vector<CSVField> fields;
+	while (reader.next(fields))
+	{
+		rows++;
+	}
+
+	return rows - 1;
+}
+
+// Generate a synthetic version of a dataset for `authorities` authorities,
+// with 4 measures (if it has more than one) over 10 years
+static std::string generateSuiteDataset(const BethYw::InputFileSource &source, unsigned int authorities)
+{
+	GeneratorOptions options;
+	options.authorities = authorities;
+	options.measures = 4;
+	options.years = 10;
+	options.noiseColumns = 2;
+
+	std::ostringstream os;
+	DatasetGenerator(options).write(os, source);
+	return os.str();
+}
+
+// Import a dataset into areas
+static void importSuiteInput(Areas &areas, const SuiteInput &input)
+{
+	areas.populate(input.contents.data(),
+				   input.contents.data() + input.contents.size(),
+				   input.source.PARSER,
+				   input.source.COLS);
+}
+
+// Run `run` on the result of `setup` repeatedly, for at least a quarter of a
+// second of `run`, and print its throughput over `items` (e.g. rows) and
+// `bytes` (if any), and the heap allocations made by each run
+template <typename Setup, typename Run>
+static void reportSuiteThroughput(const std::string &name,
+								  const char *unit,
+								  size_t items,
+								  size_t bytes,
+								  Setup setup,
+								  Run run)
+{
+	using clock = std::chrono::steady_clock;
+	std::chrono::duration<double> elapsed(0);
+	size_t runs = 0;
+	size_t allocated = 0;
+
+	do
+	{
+		auto state = setup();
+
+		size_t before = allocations;
+		auto start = clock::now();
+		volatile size_t result = run(state);
+		elapsed += clock::now() - start;
+		allocated += allocations - before;
+
+		(void)result;
+		runs++;
+	} while (elapsed.count() < 0.25);
+
+	std::cout << name << ": " << (items * runs) / elapsed.count() << " " << unit << "/s, ";
+	if (bytes != 0)
+	{
+		std::cout << (bytes * runs / 1e6) / elapsed.count() << " MB/s, ";
+	}
+	std::cout << allocated / runs << " allocations/run" << std::endl;
+}
+
+// The inputs for the import benchmarks: the bundled datasets, and the
+// synthetic ones at each scale. AuthorityByYearCSV datasets can only be
+// imported once their areas are, so each has the areas.csv to import first
+struct SuiteImport
+{
+	SuiteInput input;
+	const SuiteInput *areas;
+};
+
+static std::vector<SuiteInput> suiteAreasInputs()
+{
+	std::vector<SuiteInput> inputs;
+
+	const auto &source = BethYw::InputFiles::AREAS;
+	std::string contents = readSuiteDataset(source.FILE);
+	inputs.push_back(SuiteInput{source.FILE, source, contents, countSuiteRows(contents, source)});
+
+	for (unsigned int authorities : {1000u, 10000u})
+	{
+		contents = generateSuiteDataset(source, authorities);
+		inputs.push_back(SuiteInput{"synthetic areas.csv, " + std::to_string(authorities) + " authorities",
+									source,
+									contents,
+									countSuiteRows(contents, source)});
+	}
+
+	return inputs;
+}
+
+TEST_CASE("Benchmark suite: import", "[benchmark][suite][import]")
+{
+	const std::vector<SuiteInput> areas = suiteAreasInputs();
+	std::vector<SuiteImport> imports;
+
+	for (auto &input : areas)
+	{
+		imports.push_back(SuiteImport{input, nullptr});
+	}
+
+	for (auto &source : BethYw::InputFiles::DATASETS)
+	{
+		std::string contents = readSuiteDataset(source.FILE);
+		imports.push_back(SuiteImport{SuiteInput{source.FILE, source, contents, countSuiteRows(contents, source)},
+									  source.PARSER == BethYw::AuthorityByYearCSV ? &areas[0] : nullptr});
+	}
+
+	const unsigned int scales[] = {1000, 10000};
+	for (size_t s = 0; s < 2; s++)
+	{
+		const std::string suffix = ", " + std::to_string(scales[s]) + " authorities";
+
+		const auto &json = BethYw::InputFiles::POPDEN;
+		std::string contents = generateSuiteDataset(json, scales[s]);
+		imports.push_back(SuiteImport{SuiteInput{"synthetic " + json.FILE + suffix, json, contents, countSuiteRows(contents, json)},
+									  nullptr});
+
+		const auto &csv = BethYw::InputFiles::COMPLETE_POP;
+		contents = generateSuiteDataset(csv, scales[s]);
+		imports.push_back(SuiteImport{SuiteInput{"synthetic " + csv.FILE + suffix, csv, contents, countSuiteRows(contents, csv)},
+									  &areas[s + 1]});
+	}
+
+	for (auto &import : imports)
+	{
+		const SuiteInput &input = import.input;
+
+		// The Areas each run imports into (with the areas already imported, if
+		// the dataset needs them)
+		Areas base;
+		if (import.areas != nullptr)
+		{
+			importSuiteInput(base, *import.areas);
+		}
+
+		reportSuiteThroughput(
+			input.name, "rows", input.rows, input.contents.size(),
+			[&]()
+			{ return Areas(base); },
+			[&](Areas &areas)
+			{
+				importSuiteInput(areas, input);
+				return static_cast<size_t>(areas.size());
+			});
+
+		BENCHMARK_ADVANCED(std::string(input.name))(Catch::Benchmark::Chronometer meter)
+		{
+			std::vector<Areas> areas(meter.runs(), base);
+			meter.measure([&](int i)
+						  {
+							  importSuiteInput(areas[i], input);
+							  return areas[i].size();
+						  });
+		};
+	}
+}
+
+// Build an Areas object with all of the bundled datasets, or with the
+// synthetic datasets for `authorities` authorities
+static Areas suiteAreas(unsigned int authorities)
+{
+	Areas areas;
+
+	if (authorities == 0)
+	{
+		const auto &codes = BethYw::InputFiles::AREAS;
+		importSuiteInput(areas, SuiteInput{codes.FILE, codes, readSuiteDataset(codes.FILE), 0});
+
+		for (auto &source : BethYw::InputFiles::DATASETS)
+		{
+			std::string contents = readSuiteDataset(source.FILE);
+			importSuiteInput(areas, SuiteInput{source.FILE, source, contents, 0});
+		}
+
+		return areas;
+	}
+
+	const auto &codes = BethYw::InputFiles::AREAS;
+	importSuiteInput(areas, SuiteInput{codes.FILE, codes, generateSuiteDataset(codes, authorities), 0});
+
+	const auto &json = BethYw::InputFiles::POPDEN;
+	importSuiteInput(areas, SuiteInput{json.FILE, json, generateSuiteDataset(json, authorities), 0});
+
+	const auto &csv = BethYw::InputFiles::COMPLETE_POP;
+	importSuiteInput(areas, SuiteInput{csv.FILE, csv, generateSuiteDataset(csv, authorities), 0});
+
+	return areas;
+}
+
+// Count the values (readings) in an Areas object
+static size_t countSuiteValues(Areas &areas)
+{
+	size_t values = 0;
+
+	for (auto &code : areas.getAllAuthorityCodes())
+	{
+		Area &area = areas.getArea(code);
+		for (auto &codename : area.getAllMeasureCodenames())
+		{
+			values += area.getMeasure(codename).size();
+		}
+	}
+
+	return values;
+}
+
+TEST_CASE("Benchmark suite: query and export", "[benchmark][suite][query][export]")
+{
+	const unsigned int scales[] = {0, 1000, 10000};
+
+	for (auto authorities : scales)
+	{
+		Areas areas = suiteAreas(authorities);
+		const Areas &constAreas = areas;
+
+		const std::string suffix = authorities == 0 ? " (bundled datasets)"
+													: " (" + std::to_string(authorities) + " synthetic authorities)";
+		const size_t values = countSuiteValues(areas);
+		const std::vector<std::string> codes = areas.getAllAuthorityCodes();
+
+		// Every Measure, so that the statistics and lookups are not timing the
+		// walk to find them
+		std::vector<const Measure *> measures;
+		std::vector<std::pair<std::string, std::string>> lookups;
+		for (auto &code : codes)
+		{
+			Area &area = areas.getArea(code);
+			for (auto &codename : area.getAllMeasureCodenames())
+			{
+				measures.push_back(&area.getMeasure(codename));
+				lookups.push_back(std::make_pair(code, codename));
+			}
+		}
+
+		auto none = []()
+		{ return 0; };
+
+		auto toJSON = [&](int)
+		{ return constAreas.toJSON().size(); };
+
+		auto toTable = [&](int)
+		{
+			std::ostringstream os;
+			os << constAreas;
+			return os.str().size();
+		};
+
+		auto statistics = [&](int)
+		{
+			double sum = 0;
+			for (auto measure : measures)
+			{
+				sum += measure->getAverage() + measure->getDifference() + measure->getDifferenceAsPercentage();
+			}
+			return static_cast<size_t>(sum != 0);
+		};
+
+		auto getMeasure = [&](int)
+		{
+			size_t found = 0;
+			for (auto &lookup : lookups)
+			{
+				found += areas.getArea(lookup.first).getMeasure(lookup.second).size();
+			}
+			return found;
+		};
+
+		// A query of one authority over a decade, as the server answers: a view
+		// of the loaded data, or a copy of it
+		const StringFilterSet queryAreas = {codes[codes.size() / 2]};
+		const YearFilterTuple queryYears = std::make_tuple(2000, 2009);
+
+		auto query = [&](int)
+		{ return constAreas.query(&queryAreas, nullptr, &queryYears).toJSON().size(); };
+
+		auto select = [&](int)
+		{ return constAreas.select(&queryAreas, nullptr, &queryYears).toJSON().size(); };
+
+		// A measure of every authority, and every value for a year, found by
+		// walking every area or from the indexes (built once, up front)
+		auto walkMeasure = [&](int)
+		{
+			size_t found = 0;
+			for (auto &code : codes)
+			{
+				const Area &area = constAreas.getArea(code);
+				for (auto &codename : area.getAllMeasureCodenames())
+				{
+					found += codename == "pop" ? area.getMeasure(codename).size() : 0;
+				}
+			}
+			return found;
+		};
+
+		auto indexMeasure = [&](int)
+		{
+			size_t found = 0;
+			for (auto &entry : constAreas.getMeasureIndex("pop"))
+			{
+				found += entry.measure->size();
+			}
+			return found;
+		};
+
+		auto walkYear = [&](int)
+		{
+			double sum = 0;
+			for (auto measure : measures)
+			{
+				for (auto reading : *measure)
+				{
+					sum += reading.year == 1995 ? reading.value : 0;
+				}
+			}
+			return static_cast<size_t>(sum != 0);
+		};
+
+		auto indexYear = [&](int)
+		{
+			double sum = 0;
+			for (auto &entry : constAreas.getYearIndex(1995))
+			{
+				sum += entry.measure->getValue(1995);
+			}
+			return static_cast<size_t>(sum != 0);
+		};
+
+		// Every Area compared with that of a copy, as when diffing snapshots
+		const Areas copy(areas);
+		auto equal = [&](int)
+		{
+			size_t same = 0;
+			for (auto &code : codes)
+			{
+				same += constAreas.getArea(code) == copy.getArea(code);
+			}
+			return same;
+		};
+
+		areas.buildIndexes();
+
+		const size_t jsonBytes = toJSON(0);
+		const size_t tableBytes = toTable(0);
+
+		reportSuiteThroughput("Areas::toJSON" + suffix, "values", values, jsonBytes, none, toJSON);
+		reportSuiteThroughput("operator<<(Areas)" + suffix, "values", values, tableBytes, none, toTable);
+		reportSuiteThroughput("Measure statistics" + suffix, "measures", measures.size(), 0, none, statistics);
+		reportSuiteThroughput("Areas::getArea + Area::getMeasure" + suffix, "lookups", lookups.size(), 0, none, getMeasure);
+		reportSuiteThroughput("Areas::query" + suffix, "queries", 1, 0, none, query);
+		reportSuiteThroughput("Areas::select" + suffix, "queries", 1, 0, none, select);
+		reportSuiteThroughput("Area operator== with a copy" + suffix, "areas", codes.size(), 0, none, equal);
+		reportSuiteThroughput("pop of every area, walked" + suffix, "queries", 1, 0, none, walkMeasure);
+		reportSuiteThroughput("pop of every area, Areas::getMeasureIndex" + suffix, "queries", 1, 0, none, indexMeasure);
+		reportSuiteThroughput("every value for 1995, walked" + suffix, "queries", 1, 0, none, walkYear);
+		reportSuiteThroughput("every value for 1995, Areas::getYearIndex" + suffix, "queries", 1, 0, none, indexYear);
+
+		BENCHMARK("Areas::toJSON" + suffix)
+		{
+			return toJSON(0);
+		};
+
+		BENCHMARK("operator<<(Areas)" + suffix)
+		{
+			return toTable(0);
+		};
+
+		BENCHMARK("Measure statistics" + suffix)
+		{
+			return statistics(0);
+		};
+
+		BENCHMARK("Areas::getArea + Area::getMeasure" + suffix)
+		{
+			return getMeasure(0);
+		};
+
+		BENCHMARK("Areas::query" + suffix)
+		{
+			return query(0);
+		};
+
+		BENCHMARK("Areas::select" + suffix)
+		{
+			return select(0);
+		};
+
+		BENCHMARK("Area operator== with a copy" + suffix)
+		{
+			return equal(0);
+		};
+
+		BENCHMARK("pop of every area, Areas::getMeasureIndex" + suffix)
+		{
+			return indexMeasure(0);
+		};
+
+		BENCHMARK("every value for 1995, Areas::getYearIndex" + suffix)
+		{
+			return indexYear(0);
+		};
+	}
+}
@@ -0,0 +1,22 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 benchmark script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+
+  Every benchmark, as one executable, e.g.
+	./build.sh benchall && ./bin/bethyw-bench
+ */
+
+#include "bench1.cpp"
+#include "bench2.cpp"
+#include "bench3.cpp"
+#include "bench4.cpp"
+#include "bench5.cpp"
@@ -21,13 +21,34 @@
   additional functions not specified.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <vector>
 #include <ctype.h>
 #include <tuple>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <process.h>
+#include <windows.h>
+#else
+#include <stdlib.h>
+#include <unistd.h>
+#endif
 
 #include "lib_cxxopts.hpp"
 
@@ -35,6 +56,22 @@
 #include "datasets.h"
 #include "bethyw.h"
 #include "input.h"
+#include "server.h"
+#include "stats.h"
+
+// Auxiliary function to write the statistics (if --stats was given) to the
+// standard error, so they never mix with the output
+static void writeStats(Stats::Format format)
+{
+	if (format == Stats::TEXT)
+	{
+		Stats::writeText(std::cerr);
+	}
+	else if (format == Stats::JSON)
+	{
+		Stats::writeJSON(std::cerr);
+	}
+}
 
 /*
   Run Beth Yw?, parsing the command line arguments, importing the data,
@@ -54,6 +91,9 @@
 */
 int BethYw::run(int argc, char *argv[])
 {
+	// Started before --stats is parsed, so that parsing is timed too
+	Stats::ScopedTimer argumentsTimer("arguments");
+
 	auto cxxopts = BethYw::cxxoptsSetup();
 	auto args = cxxopts.parse(argc, argv);
 
@@ -74,28 +114,87 @@ int BethYw::run(int argc, char *argv[])
 		auto areasFilter = BethYw::parseAreasArg(args);
 		auto measuresFilter = BethYw::parseMeasuresArg(args);
 		auto yearsFilter = BethYw::parseYearsArg(args);
+		auto threads = BethYw::parseThreadsArg(args);
+		auto statsFormat = BethYw::parseStatsArg(args);
+
+		if (statsFormat != Stats::NONE)
+		{
+			Stats::enable();
+		}
+		argumentsTimer.stop();
 
 		Areas data = Areas();
 
-		BethYw::loadAreas(data, dir, &areasFilter);
+		// Reuse the snapshot of a previous run that imported the same datasets
+		// if none of the files it was imported from have changed since. Only
+		// an import without filters is saved and reused: the filters are
+		// applied to each row as it is imported, which cannot be repeated on
+		// the merged data (e.g. the rows of a CSV dataset have no names), and
+		// a filtered import skips most rows before decoding them anyway
+		const bool filtered = !areasFilter.empty() ||
+							  !measuresFilter.empty() ||
+							  std::get<0>(yearsFilter) != 0 ||
+							  std::get<1>(yearsFilter) != 0;
+
+		std::string signature;
+		const std::string snapshotPath = BethYw::snapshotPath(dir);
+		bool loaded = false;
+
+		if (!filtered && !args.count("no-snapshot"))
+		{
+			Stats::ScopedTimer timer("loadSnapshot");
 
-		BethYw::loadDatasets(data,
-							 dir,
-							 datasetsToImport,
-							 &areasFilter,
-							 &measuresFilter,
-							 &yearsFilter);
+			signature = BethYw::snapshotSignature(dir, datasetsToImport);
+			loaded = !signature.empty() && BethYw::loadSnapshot(data, snapshotPath, signature);
+		}
 
-		if (args.count("json"))
+		if (!loaded)
 		{
-			// The output as JSON
-			std::cout << data.toJSON() << std::endl;
+			BethYw::loadAreas(data, dir, &areasFilter);
+
+			bool imported = BethYw::loadDatasets(data,
+												 dir,
+												 datasetsToImport,
+												 &areasFilter,
+												 &measuresFilter,
+												 &yearsFilter,
+												 threads);
+
+			// Only cache a complete import, so that any errors are reported
+			// again on the next run
+			if (imported && !signature.empty())
+			{
+				Stats::ScopedTimer timer("saveSnapshot");
+				BethYw::saveSnapshot(data, snapshotPath, signature);
+			}
 		}
-		else
+
+		// Keep the data in memory and answer queries over it, instead of
+		// printing it (see server.h)
+		if (args.count("serve"))
+		{
+			writeStats(statsFormat);
+			BethYw::serve(data, args["serve"].as<std::string>());
+			return 0;
+		}
+
 		{
-			// The output as tables
-			std::cout << data;
+			Stats::ScopedTimer timer("output");
+
+			if (args.count("json"))
+			{
+				// The output as JSON
+				data.writeJSON(std::cout);
+				std::cout << std::endl;
+			}
+			else
+			{
+				// The output as tables
+				std::cout << data;
+			}
 		}
+
+		writeStats(statsFormat);
 	}
 	catch (const std::invalid_argument &e)
 	{
@@ -163,6 +262,30 @@ cxxopts::Options BethYw::cxxoptsSetup()
 		"j,json",
 		"Print the output as JSON instead of tables.")(
 
+		"threads",
+		"Number of datasets to import concurrently (output is the same as "
+		"importing them one after another)",
+		cxxopts::value<std::string>()->default_value("1"))(
+
+		"no-snapshot",
+		"Always import the datasets, instead of reusing the snapshot saved in "
+		"the data directory by a previous run without --areas, --measures or "
+		"--years that imported the same datasets")(
+
+		"stats",
+		"Print the time taken by each phase of the run, the rows read and "
+		"filtered out, the bytes read, the heap allocations and the peak "
+		"memory use to the standard error, as a table or (with --stats=json) "
+		"as JSON",
+		cxxopts::value<std::string>()->implicit_value("text"))(
+
+		"serve",
+		"Import the datasets once, then answer queries for them over HTTP on "
+		"this port of 127.0.0.1, or on this Unix domain socket path, until "
+		"stopped (see server.h). Clients are answered one at a time, and one "
+		"that sends nothing for 5 seconds is disconnected",
+		cxxopts::value<std::string>())(
+
 		"h,help",
 		"Print usage.");
 
@@ -468,6 +591,97 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(
 		throw std::invalid_argument("Invalid input for years argument");
 	}
 }
+/*
+  Parse the threads command line argument. This is the number of datasets that
+  may be imported at the same time, which must be a positive integer. If the
+  argument is not given, datasets are imported one after another (i.e. 1).
+
+  @param args
+	Parsed program arguments
+
+  @return
+	The number of threads to import datasets with
+
+  @throws
+	std::invalid_argument if the argument is not a positive integer with the
+	message: Invalid input for threads argument
+*/
+unsigned int BethYw::parseThreadsArg(cxxopts::ParseResult &args)
+{
+	std::string inputThreads;
+
+	try
+	{
+		inputThreads = args["threads"].as<std::string>();
+	}
+	catch (const std::bad_cast &e)
+	{
+		throw std::invalid_argument("Invalid input for threads argument");
+	}
+	catch (const std::domain_error &e)
+	{
+		return 1;
+	}
+
+	// Only accept digits, stoul() would accept e.g. "-1" or "2x"
+	if (inputThreads.empty() || inputThreads.size() > 4 ||
+		!std::all_of(inputThreads.begin(), inputThreads.end(),
+					 [](unsigned char c) { return std::isdigit(c) != 0; }) ||
+		std::stoul(inputThreads) == 0)
+	{
+		throw std::invalid_argument("Invalid input for threads argument");
+	}
+
+	return std::stoul(inputThreads);
+}
+
+/*
+  Parse the stats command line argument, which is optional. Without it, no
+  statistics are printed. With it but no value (i.e. --stats), they are
+  printed as a table, or with --stats=json as JSON.
+
+  @param args
+	Parsed program arguments
+
+  @return
+	How to print the statistics, or Stats::NONE if they should not be
+
+  @throws
+	std::invalid_argument if the argument is not text or json with the
+	message: Invalid input for stats argument
+*/
+Stats::Format BethYw::parseStatsArg(cxxopts::ParseResult &args)
+{
+	std::string inputStats;
+
+	try
+	{
+		inputStats = args["stats"].as<std::string>();
+	}
+	catch (const std::bad_cast &e)
+	{
+		throw std::invalid_argument("Invalid input for stats argument");
+	}
+	catch (const std::domain_error &e)
+	{
+		return Stats::NONE;
+	}
+
+	std::transform(inputStats.begin(), inputStats.end(), inputStats.begin(),
+				   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+	if (inputStats == "text")
+	{
+		return Stats::TEXT;
+	}
+	else if (inputStats == "json")
+	{
+		return Stats::JSON;
+	}
+
+	throw std::invalid_argument("Invalid input for stats argument");
+}
+
 /*
   TODO: BethYw::loadAreas(areas, dir, areasFilter)
 
@@ -505,12 +719,20 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(
 */
 void BethYw::loadAreas(Areas &areas, std::string dir, const StringFilterSet *const areasFilter)
 {
+	Stats::ScopedTimer timer("import " + InputFiles::AREAS.FILE);
 	InputFile inputf(dir + InputFiles::AREAS.FILE);
 
 	try
 	{
 		std::istream &is = inputf.open();
 
+		// The file is read as a stream, so find its size just to count it
+		if (Stats::enabled() && is.seekg(0, std::ios::end))
+		{
+			Stats::add(Stats::BYTES_READ, static_cast<std::uint64_t>(is.tellg()));
+			is.seekg(0, std::ios::beg);
+		}
+
 		areas.populate(is, BethYw::AuthorityCodeCSV, BethYw::InputFiles::AREAS.COLS, areasFilter);
 	}
 	catch (const std::runtime_error &e)
@@ -562,8 +784,15 @@ void BethYw::loadAreas(Areas &areas, std::string dir, const StringFilterSet *con
 	An two-pair tuple of unsigned ints corresponding to the range of years
 	to import, which should both be 0 to import all years.
 
+  @param threads
+	The number of datasets to import concurrently. With more than one thread,
+	each dataset is imported into a separate Areas instance and these are
+	merged into areas in the order of datasetsToImport, so the result is the
+	same as with one thread.
+
   @return
-	void
+	true if every dataset was imported, or false if an error was reported for
+	any of them
 
   @example
 	Areas areas();
@@ -576,27 +805,361 @@ void BethYw::loadAreas(Areas &areas, std::string dir, const StringFilterSet *con
 	  BethYw::parseMeasuresArg(args),
 	  BethYw::parseYearsArg(args));
 */
-void BethYw::loadDatasets(Areas &areas,
+// Auxiliary function to import a single dataset into areas, reporting (and
+// swallowing) any std::runtime_error as loadDatasets() requires. Returns false
+// if an error was reported.
+static bool loadDataset(Areas &areas,
+						const std::string &dir,
+						const BethYw::InputFileSource &dataset,
+						const StringFilterSet *const areasFilter,
+						const StringFilterSet *const measuresFilter,
+						const YearFilterTuple *const yearsFilter)
+{
+	Stats::ScopedTimer timer("import " + dataset.FILE);
+	InputMappedFile inputf(dir + dataset.FILE);
+
+	try
+	{
+		inputf.open();
+		Stats::add(Stats::BYTES_READ, inputf.size());
+
+		areas.populate(inputf.begin(),
+					   inputf.end(),
+					   dataset.PARSER,
+					   dataset.COLS,
+					   areasFilter,
+					   measuresFilter,
+					   yearsFilter);
+	}
+	catch (const std::runtime_error &e)
+	{
+		std::cerr << "Error importing dataset:" << std::endl;
+		std::cerr << e.what() << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool BethYw::loadDatasets(Areas &areas,
 						  std::string dir,
 						  std::vector<BethYw::InputFileSource> datasetsToImport,
 						  const StringFilterSet *const areasFilter,
 						  const StringFilterSet *const measuresFilter,
-						  const YearFilterTuple *const yearsFilter)
+						  const YearFilterTuple *const yearsFilter,
+						  const unsigned int threads)
+{
+	const size_t numDatasets = datasetsToImport.size();
+
+	if (threads <= 1 || numDatasets <= 1)
+	{
+		bool imported = true;
+		for (auto &dataset : datasetsToImport)
+		{
+			imported &= loadDataset(areas, dir, dataset, areasFilter, measuresFilter, yearsFilter);
+		}
+
+		return imported;
+	}
+
+	// Each dataset is imported by one of the worker threads into its own
+	// partial Areas instance, so the threads share nothing but the filters
+	// (which are only read). AuthorityByYearCSV files add measures to areas
+	// that must already exist, so they start with an empty Area for each area
+	// in areas. These have no names, so that merging the partial back does not
+	// replace the names set by a dataset before it with those of areas.csv
+	Areas codes = Areas();
+	for (auto &code : areas.getAllAuthorityCodes())
+	{
+		codes.setArea(code, Area(code));
+	}
+
+	std::vector<Areas> partials(numDatasets);
+	std::vector<std::exception_ptr> errors(numDatasets);
+	std::atomic<size_t> next(0);
+
+	auto worker = [&]()
+	{
+		for (size_t i = next++; i < numDatasets; i = next++)
+		{
+			Stats::ScopedTimer timer("import " + datasetsToImport[i].FILE);
+
+			try
+			{
+				if (datasetsToImport[i].PARSER == BethYw::AuthorityByYearCSV)
+				{
+					partials[i] = codes;
+				}
+
+				InputMappedFile inputf(dir + datasetsToImport[i].FILE);
+				inputf.open();
+				Stats::add(Stats::BYTES_READ, inputf.size());
+
+				partials[i].populate(inputf.begin(),
+									 inputf.end(),
+									 datasetsToImport[i].PARSER,
+									 datasetsToImport[i].COLS,
+									 areasFilter,
+									 measuresFilter,
+									 yearsFilter);
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < threads && i < numDatasets; i++)
+	{
+		workers.push_back(std::thread(worker));
+	}
+
+	for (auto &thread : workers)
+	{
+		thread.join();
+	}
+
+	// Merge the partials in the order the datasets were given, so the result
+	// is the same as importing them one after another. If a dataset failed,
+	// it is imported again at this point instead: the error is then reported
+	// (or thrown) in the same order and with the same preceding state as when
+	// importing serially, e.g. an AuthorityByYearCSV file that refers to an
+	// area created by an earlier dataset.
+	Stats::ScopedTimer timer("merge");
+	bool imported = true;
+	for (size_t i = 0; i < numDatasets; i++)
+	{
+		if (errors[i])
+		{
+			imported &= loadDataset(areas, dir, datasetsToImport[i], areasFilter, measuresFilter, yearsFilter);
+		}
+		else
+		{
+			areas.merge(std::move(partials[i]));
+		}
+	}
+
+	return imported;
+}
+
+/*
+  Build the signature of an unfiltered import: the datasets imported, in
+  order, and for areas.csv and each dataset file, its size and modification
+  time. Two runs with the same signature import exactly the same data, so the
+  second can reuse a snapshot saved by the first.
+
+  @param dir
+	The directory where the areas.csv file and datasets are
+
+  @param datasetsToImport
+	A vector of InputFileSource objects
+
+  @return
+	The signature, or an empty string if any of the files could not be found
+	(in which case the import should not use a snapshot)
+
+  @example
+	auto signature = BethYw::snapshotSignature(dir, datasetsToImport);
+*/
+std::string BethYw::snapshotSignature(const std::string &dir,
+									  const std::vector<BethYw::InputFileSource> &datasetsToImport)
 {
-	for (auto dataset : datasetsToImport)
+	std::ostringstream signature;
+
+	std::vector<std::string> files = {InputFiles::AREAS.FILE};
+	for (auto &dataset : datasetsToImport)
 	{
-		InputFile inputf(dir + dataset.FILE);
+		files.push_back(dataset.FILE);
+	}
 
-		try
+	for (auto &file : files)
+	{
+		struct stat info;
+		if (stat((dir + file).c_str(), &info) != 0)
 		{
-			std::istream &is = inputf.open();
+			return "";
+		}
+
+		signature << "file=" << file << '\n'
+				  << "stat=" << static_cast<unsigned long long>(info.st_size) << ':'
+				  << static_cast<long long>(info.st_mtime);
+#ifdef __linux__
+		// A file may be changed more than once in the same second
+		signature << '.' << info.st_mtim.tv_nsec;
+#endif
+		signature << '\n';
+	}
 
-			areas.populate(is, dataset.PARSER, dataset.COLS, areasFilter, measuresFilter, yearsFilter);
+	return signature.str();
+}
+
+/*
+  Get the path of the snapshot in the data directory. There is only one, which
+  the next unfiltered import of a different list of datasets, or after any of
+  the datasets have changed, replaces.
+
+  @param dir
+	The directory where the datasets are
+
+  @return
+	The path of the snapshot file
+
+  @example
+	auto path = BethYw::snapshotPath(dir);
+*/
+std::string BethYw::snapshotPath(const std::string &dir)
+{
+	return dir + ".bethyw-import.snapshot";
+}
+
+/*
+  Load the snapshot at path into areas, if it exists and was saved for an
+  import with the given signature. A missing, outdated or malformed snapshot is
+  not an error: the caller should just import the datasets instead.
+
+  @param areas
+	An Areas instance that should be modified. It is left unchanged if the
+	snapshot cannot be loaded.
+
+  @param path
+	The path of the snapshot, from snapshotPath()
+
+  @param signature
+	The signature of the import, from snapshotSignature()
+
+  @return
+	true if the snapshot was loaded into areas, false otherwise
+
+  @example
+	if (!BethYw::loadSnapshot(areas, path, signature)) {
+	  BethYw::loadAreas(areas, dir, &areasFilter);
+	  ...
+	}
+*/
+bool BethYw::loadSnapshot(Areas &areas, const std::string &path, const std::string &signature)
+{
+	// The whole snapshot is read at once (mapped, where possible), and then
+	// decoded from memory
+	InputMappedFile file(path);
+
+	try
+	{
+		file.open();
+	}
+	catch (const std::runtime_error &e)
+	{
+		return false;
+	}
+
+	const char *begin = file.begin();
+	const char *end = file.end();
+
+	std::uint32_t length = 0;
+	if (static_cast<size_t>(end - begin) < sizeof(length))
+	{
+		return false;
+	}
+
+	std::memcpy(&length, begin, sizeof(length));
+	begin += sizeof(length);
+
+	if (length != signature.size() ||
+		static_cast<size_t>(end - begin) < length ||
+		signature.compare(0, length, begin, length) != 0)
+	{
+		return false;
+	}
+
+	try
+	{
+		Areas snapshot = Areas();
+		snapshot.readSnapshot(begin + length, end);
+		areas.merge(std::move(snapshot));
+	}
+	catch (const std::runtime_error &e)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/*
+  Save areas as the snapshot for an import with the given signature. The
+  snapshot is written to a temporary file unique to this run, which then
+  atomically replaces any existing snapshot, so a concurrent run never reads a
+  partially written one. Failing to
+  save the snapshot (e.g. if the data directory is read-only) is not an error.
+
+  @param areas
+	The Areas instance to save
+
+  @param path
+	The path of the snapshot, from snapshotPath()
+
+  @param signature
+	The signature of the import, from snapshotSignature()
+
+  @return
+	void
+
+  @example
+	BethYw::saveSnapshot(areas, path, signature);
+*/
+void BethYw::saveSnapshot(const Areas &areas, const std::string &path, const std::string &signature)
+{
+	// Each run writes its own temporary file, so concurrent runs never write
+	// into the same file
+#ifdef _WIN32
+	const std::string tmpPath = path + "." + std::to_string(_getpid()) + ".tmp";
+#else
+	std::string tmpPath = path + ".XXXXXX";
+	const int fd = mkstemp(&tmpPath[0]);
+	if (fd == -1)
+	{
+		return;
+	}
+
+	// mkstemp() creates the file readable by its owner only. Give it the
+	// permissions a new file would have, so that other users' runs can read
+	// and replace the snapshot in a shared data directory
+	const mode_t mask = umask(0);
+	umask(mask);
+	fchmod(fd, 0666 & ~mask);
+	close(fd);
+#endif
+
+	{
+		std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			std::remove(tmpPath.c_str());
+			return;
 		}
-		catch (const std::runtime_error &e)
+
+		std::uint32_t length = signature.size();
+		file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+		file.write(signature.data(), signature.size());
+		areas.writeSnapshot(file);
+
+		file.close();
+		if (!file)
 		{
-			std::cerr << "Error importing dataset:" << std::endl;
-			std::cerr << e.what() << std::endl;
+			std::remove(tmpPath.c_str());
+			return;
 		}
 	}
+
+	// Replace the snapshot in one step, so there is always a complete one
+#ifdef _WIN32
+	const bool replaced = MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	const bool replaced = std::rename(tmpPath.c_str(), path.c_str()) == 0;
+#endif
+	if (!replaced)
+	{
+		std::remove(tmpPath.c_str());
+	}
 }
\ No newline at end of file
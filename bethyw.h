@@ -23,6 +23,7 @@
 #include "lib_cxxopts.hpp"
 
 #include "datasets.h"
+#include "stats.h"
 
 const char DIR_SEP =
 #ifdef _WIN32
@@ -63,15 +64,24 @@ namespace BethYw
 	std::unordered_set<std::string> parseAreasArg(cxxopts::ParseResult &args);
 	std::unordered_set<std::string> parseMeasuresArg(cxxopts::ParseResult &args);
 	std::tuple<unsigned int, unsigned int> parseYearsArg(cxxopts::ParseResult &args);
+	unsigned int parseThreadsArg(cxxopts::ParseResult &args);
+	Stats::Format parseStatsArg(cxxopts::ParseResult &args);
 
 	void loadAreas(Areas &areas, std::string dir, const StringFilterSet *const areasFilter);
 
-	void loadDatasets(Areas &data,
+	bool loadDatasets(Areas &data,
 					  std::string dir,
 					  std::vector<BethYw::InputFileSource> datasetsToImport,
 					  const StringFilterSet *const areasFilter,
 					  const StringFilterSet *const measuresFilter,
-					  const YearFilterTuple *const yearsFilter);
+					  const YearFilterTuple *const yearsFilter,
+					  const unsigned int threads = 1);
+
+	std::string snapshotSignature(const std::string &dir,
+								  const std::vector<BethYw::InputFileSource> &datasetsToImport);
+	std::string snapshotPath(const std::string &dir);
+	bool loadSnapshot(Areas &areas, const std::string &path, const std::string &signature);
+	void saveSnapshot(const Areas &areas, const std::string &path, const std::string &signature);
 
 } // namespace BethYw
 
@@ -2,9 +2,12 @@
 
 SET bin_dir=bin
 SET tests_dir=tests
-SET source_files=bethyw.cpp input.cpp areas.cpp area.cpp measure.cpp
-SET main_file=main.cpp
+SET benchmarks_dir=benchmarks
+SET tools_dir=tools
+SET source_files=bethyw.cpp input.cpp csv.cpp filter.cpp symbols.cpp arena.cpp stats.cpp server.cpp generator.cpp areas.cpp area.cpp measure.cpp view.cpp
+SET main_file=main.cpp allocations.cpp
 SET executable=%bin_dir%\bethyw.exe
+SET extra_flags=
 
 COPY bin\bethyw2.exe bin\bethyw.exe
 
@@ -22,9 +25,28 @@ IF %testStr%==test (
   )
 )
 
+SET benchStr=%1%
+SET benchStr=%benchStr:~0,5%
+IF %benchStr%==bench (
+  SET source_files=%source_files% %benchmarks_dir%\%1%.cpp
+  SET main_file=%bin_dir%\catch-bench.o
+  SET executable=%bin_dir%\bethyw-bench.exe
+  SET extra_flags=-O2
+
+  IF NOT EXIST %bin_dir%\catch-bench.o (
+     g++ --std=c++11 -DCATCH_CONFIG_ENABLE_BENCHMARKING -c lib_catch_main.cpp -o %bin_dir%\catch-bench.o
+  )
+)
+
+IF "%1"=="generate" (
+  SET main_file=%tools_dir%\generate.cpp
+  SET executable=%bin_dir%\bethyw-generate.exe
+  SET extra_flags=-O2
+)
+
 :compile
 IF NOT EXIST %bin_dir% MKDIR %bin_dir%
 IF EXIST %executable% DEL %executable%
-g++ --std=c++14 -Wall %source_files% %main_file% -o %executable%
+g++ --std=c++14 -Wall -pthread %extra_flags% %source_files% %main_file% -o %executable%
 
 :end
@@ -2,15 +2,19 @@
 
 BIN_DIR="bin"
 TESTS_DIR="tests"
-SOURCE_FILES="bethyw.cpp input.cpp areas.cpp area.cpp measure.cpp"
-MAIN_FILE="main.cpp"
+BENCHMARKS_DIR="benchmarks"
+TOOLS_DIR="tools"
+SOURCE_FILES="bethyw.cpp input.cpp csv.cpp filter.cpp symbols.cpp arena.cpp stats.cpp server.cpp generator.cpp areas.cpp area.cpp measure.cpp view.cpp"
+MAIN_FILE="main.cpp allocations.cpp"
 EXECUTABLE="./${BIN_DIR}/bethyw"
+EXTRA_FLAGS=""
 
 set -x
 cd "${0%/*}"
+mkdir -p ${BIN_DIR}
 
 if [ $# -gt 1 ]; then
-  echo "Unknown arguments!" "Only one argument accepted, and must begin with test"
+  echo "Unknown arguments!" "Only one argument accepted, and must begin with test or bench, or be generate"
   exit
 elif [ $# -eq 1 ]; then
   if [[ $1 == test* ]]; then
@@ -22,9 +26,23 @@ elif [ $# -eq 1 ]; then
     if [ ! -f ./${BIN_DIR}/catch.o ]; then
       g++ --std=c++11 -c ./lib_catch_main.cpp -o ./${BIN_DIR}/catch.o
     fi
+  elif [[ $1 == bench* ]]; then
+    SOURCE_FILES="${SOURCE_FILES} ./${BENCHMARKS_DIR}/$1.cpp"
+    MAIN_FILE="./${BIN_DIR}/catch-bench.o"
+    EXECUTABLE="./${BIN_DIR}/bethyw-bench"
+    # Timings of an unoptimised build are meaningless
+    EXTRA_FLAGS="-O2"
+
+    # Do we need to compile Catch2 with benchmarking enabled?
+    if [ ! -f ./${BIN_DIR}/catch-bench.o ]; then
+      g++ --std=c++11 -DCATCH_CONFIG_ENABLE_BENCHMARKING -c ./lib_catch_main.cpp -o ./${BIN_DIR}/catch-bench.o
+    fi
+  elif [[ $1 == generate ]]; then
+    MAIN_FILE="./${TOOLS_DIR}/generate.cpp"
+    EXECUTABLE="./${BIN_DIR}/bethyw-generate"
+    EXTRA_FLAGS="-O2"
   fi
 fi
 
-mkdir -p ${BIN_DIR}
 rm ${EXECUTABLE} 2> /dev/null
-g++ --std=c++14 -pedantic -Wall ${SOURCE_FILES} ${MAIN_FILE} -o ${EXECUTABLE}
\ No newline at end of file
+g++ --std=c++14 -pedantic -Wall -pthread ${EXTRA_FLAGS} ${SOURCE_FILES} ${MAIN_FILE} -o ${EXECUTABLE}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#
+#  +---------------------------------------+
+#  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+#  +---------------------------------------+
+#
+#  AUTHOR: 854378
+#
+#  Training run for profile-guided optimisation, run by the pgo-train target
+#  (see CMakeLists.txt) from the source directory with:
+#
+#    BETHYW         the instrumented bethyw
+#    PGO_DIR        the directory the profile is written to
+#    COMPILER_ID    the CMAKE_CXX_COMPILER_ID
+#    LLVM_PROFDATA  llvm-profdata, to merge the raw profiles of Clang
+#
+#  bethyw imports every bundled dataset with the table and JSON output, with
+#  and without filters, and on several threads, without reading or writing a
+#  snapshot so that the importers are what is trained.
+#
+
+set(BETHYW_PGO_RUNS
+  "--no-snapshot"
+  "--no-snapshot -j"
+  "--no-snapshot -j --threads 4"
+  "--no-snapshot -d all -a swansea,W06000001 -y 2000-2010"
+  "--no-snapshot -d popden,biz -m pop,DENS,a -y 2005 -j"
+  "--no-snapshot -d complete-pop,complete-area -a cardiff -y 1995-2005"
+  "--no-snapshot -d aqi,trains -a Gwynedd,newport")
+
+foreach(run ${BETHYW_PGO_RUNS})
+  message(STATUS "bethyw ${run}")
+
+  separate_arguments(arguments UNIX_COMMAND "${run}")
+  execute_process(COMMAND ${BETHYW} ${arguments} RESULT_VARIABLE result OUTPUT_QUIET)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "bethyw ${run} failed: ${result}")
+  endif()
+endforeach()
+
+if(COMPILER_ID MATCHES "Clang")
+  if(NOT LLVM_PROFDATA)
+    message(FATAL_ERROR "llvm-profdata is needed to merge the profile of a Clang build")
+  endif()
+
+  file(GLOB raw ${PGO_DIR}/*.profraw)
+  execute_process(COMMAND ${LLVM_PROFDATA} merge -output=${PGO_DIR}/default.profdata ${raw}
+                  RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "llvm-profdata merge failed: ${result}")
+  endif()
+endif()
@@ -0,0 +1,419 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the implementation of the CSV scanner used by the CSV
+  parsers in Areas. See the header file for additional comments.
+ */
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "csv.h"
+
+/*
+  Check if the field is empty.
+
+  @return
+	true if the field has no characters (e.g. between two commas)
+*/
+bool CSVField::empty() const noexcept
+{
+	return this->begin == this->end;
+}
+
+/*
+  Copy the field to a std::string, unescaping any doubled quotes in a quoted
+  field.
+
+  @return
+	The value of the field
+
+  @example
+	// For the record: W06000001,"Ynys ""Môn""",Anglesey
+	fields[1].str(); // returns Ynys "Môn"
+*/
+std::string CSVField::str() const
+{
+	if (!this->escaped)
+	{
+		return std::string(this->begin, this->end);
+	}
+
+	std::string value;
+	value.reserve(this->end - this->begin);
+
+	for (const char *c = this->begin; c != this->end; c++)
+	{
+		value.push_back(*c);
+
+		// Skip the second quote of each escaped pair
+		if (*c == '"')
+		{
+			c++;
+		}
+	}
+
+	return value;
+}
+
+/*
+  Compare the (unescaped) value of the field to a string, without copying the
+  field unless it contains escaped quotes.
+
+  @param other
+	The string to compare against
+
+  @return
+	true if the value of the field is equal to other
+*/
+bool CSVField::operator==(const std::string &other) const
+{
+	if (this->escaped)
+	{
+		return this->str() == other;
+	}
+
+	return other.compare(0, std::string::npos, this->begin, this->end - this->begin) == 0;
+}
+
+bool CSVField::operator!=(const std::string &other) const
+{
+	return !(*this == other);
+}
+
+/*
+  Constructor for a CSVReader over the buffer [begin, end). The buffer must
+  outlive the reader and any fields read from it.
+
+  @param begin
+	The first character of the CSV
+
+  @param end
+	One past the last character of the CSV
+
+  @example
+	InputMappedFile input("data/areas.csv");
+	input.open();
+
+	CSVReader reader(input.begin(), input.end());
+*/
+CSVReader::CSVReader(const char *begin, const char *end) noexcept : pos(begin), end(end) {}
+
+/*
+  Read the next record of CSV.
+
+  @param fields
+	Cleared, and then filled with the fields of the record. This is reused by
+	the caller between records to avoid reallocating it.
+
+  @return
+	true if a record was read, or false at the end of the buffer
+
+  @throws
+	std::runtime_error if a quoted field is not terminated, or is followed by
+	something other than a comma or line break
+
+  @example
+	CSVReader reader(input.begin(), input.end());
+	std::vector<CSVField> fields;
+
+	while (reader.next(fields)) {
+	  std::cout << fields[0].str() << std::endl;
+	}
+*/
+bool CSVReader::next(std::vector<CSVField> &fields)
+{
+	fields.clear();
+
+	if (this->pos == this->end)
+	{
+		return false;
+	}
+
+	for (;;)
+	{
+		if (this->pos != this->end && *this->pos == '"')
+		{
+			// A quoted field runs until a quote that is not doubled
+			const char *start = ++this->pos;
+			bool escaped = false;
+
+			for (;;)
+			{
+				auto quote = static_cast<const char *>(std::memchr(this->pos, '"', this->end - this->pos));
+
+				if (quote == nullptr)
+				{
+					throw std::runtime_error("Malformed file: unterminated quoted field");
+				}
+
+				if (quote + 1 != this->end && *(quote + 1) == '"')
+				{
+					escaped = true;
+					this->pos = quote + 2;
+					continue;
+				}
+
+				fields.push_back(CSVField{start, quote, escaped});
+				this->pos = quote + 1;
+				break;
+			}
+
+			if (this->pos == this->end)
+			{
+				return true;
+			}
+
+			if (*this->pos == ',')
+			{
+				this->pos++;
+				continue;
+			}
+
+			if (*this->pos == '\r' && this->pos + 1 != this->end && *(this->pos + 1) == '\n')
+			{
+				this->pos++;
+			}
+
+			if (*this->pos == '\n' || (*this->pos == '\r' && this->pos + 1 == this->end))
+			{
+				this->pos++;
+				return true;
+			}
+
+			throw std::runtime_error("Malformed file: unexpected character after quoted field");
+		}
+
+		// An unquoted field runs until the next comma or newline. A quote in
+		// the middle of an unquoted field is not special, so keep looking
+		const char *start = this->pos;
+		const char *special = findCSVSpecial(this->pos, this->end);
+
+		while (special != this->end && *special == '"')
+		{
+			special = findCSVSpecial(special + 1, this->end);
+		}
+
+		if (special != this->end && *special == ',')
+		{
+			fields.push_back(CSVField{start, special, false});
+			this->pos = special + 1;
+			continue;
+		}
+
+		// The record ends at a newline or the end of the buffer
+		const char *fieldEnd = special;
+		if (fieldEnd != start && *(fieldEnd - 1) == '\r')
+		{
+			fieldEnd--;
+		}
+
+		fields.push_back(CSVField{start, fieldEnd, false});
+		this->pos = special == this->end ? this->end : special + 1;
+		return true;
+	}
+}
+
+/*
+  Find the next character in [begin, end) that is significant to CSV, i.e. a
+  comma, double quote, or newline ('\n'), checking a byte at a time.
+
+  This is the portable version of findCSVSpecial(), which is used for the
+  bytes that do not fill a whole vector, and on other architectures.
+
+  @param begin
+	The first character to check
+
+  @param end
+	One past the last character to check
+
+  @return
+	A pointer to the first comma, double quote, or newline, or end if there
+	are none
+*/
+const char *findCSVSpecialScalar(const char *begin, const char *end) noexcept
+{
+	for (; begin != end; begin++)
+	{
+		if (*begin == ',' || *begin == '"' || *begin == '\n')
+		{
+			return begin;
+		}
+	}
+
+	return end;
+}
+
+/*
+  Find the next character in [begin, end) that is significant to CSV, i.e. a
+  comma, double quote, or newline ('\n'). When compiled for AVX2 (e.g. with
+  -mavx2, or the CMake option BETHYW_NATIVE on a CPU that has it) this
+  compares 32 bytes at a time; when compiled for SSE2 (always
+  the case on x86-64) it compares 16 bytes at a time. The remaining bytes are
+  checked by findCSVSpecialScalar().
+
+  @param begin
+	The first character to check
+
+  @param end
+	One past the last character to check
+
+  @return
+	A pointer to the first comma, double quote, or newline, or end if there
+	are none
+
+  @example
+	const char *special = findCSVSpecial(line, line + length);
+	if (special != line + length && *special == ',') {
+	  ...
+	}
+*/
+const char *findCSVSpecial(const char *begin, const char *end) noexcept
+{
+#if defined(__AVX2__)
+	const __m256i commas = _mm256_set1_epi8(',');
+	const __m256i quotes = _mm256_set1_epi8('"');
+	const __m256i newlines = _mm256_set1_epi8('\n');
+
+	while (end - begin >= 32)
+	{
+		__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+		__m256i matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, commas),
+														  _mm256_cmpeq_epi8(chunk, quotes)),
+										  _mm256_cmpeq_epi8(chunk, newlines));
+		unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(matches));
+
+		if (mask != 0)
+		{
+			return begin + __builtin_ctz(mask);
+		}
+
+		begin += 32;
+	}
+#endif
+
+#if defined(__SSE2__)
+	const __m128i commas16 = _mm_set1_epi8(',');
+	const __m128i quotes16 = _mm_set1_epi8('"');
+	const __m128i newlines16 = _mm_set1_epi8('\n');
+
+	while (end - begin >= 16)
+	{
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+		__m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, commas16),
+													_mm_cmpeq_epi8(chunk, quotes16)),
+									   _mm_cmpeq_epi8(chunk, newlines16));
+		unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(matches));
+
+		if (mask != 0)
+		{
+			return begin + __builtin_ctz(mask);
+		}
+
+		begin += 16;
+	}
+#endif
+
+	return findCSVSpecialScalar(begin, end);
+}
+
+/*
+  Parse a CSV field as a year, i.e. an unsigned integer, ignoring any
+  surrounding whitespace.
+
+  @param field
+	The field to parse
+
+  @param year
+	Set to the year, if the field is one
+
+  @return
+	true if the field is a valid year, false otherwise
+*/
+bool parseCSVYear(const CSVField &field, unsigned int &year) noexcept
+{
+	const char *c = field.begin;
+	const char *end = field.end;
+
+	while (c != end && std::isspace(static_cast<unsigned char>(*c)))
+	{
+		c++;
+	}
+	while (end != c && std::isspace(static_cast<unsigned char>(*(end - 1))))
+	{
+		end--;
+	}
+
+	if (c == end || end - c > 9)
+	{
+		return false;
+	}
+
+	year = 0;
+	for (; c != end; c++)
+	{
+		if (*c < '0' || *c > '9')
+		{
+			return false;
+		}
+		year = year * 10 + (*c - '0');
+	}
+
+	return true;
+}
+
+/*
+  Parse a CSV field as a double, without building a std::string for it like
+  std::stod() would, ignoring any surrounding whitespace.
+
+  @param field
+	The field to parse
+
+  @param value
+	Set to the value, if the field is a number
+
+  @return
+	true if the field is a valid number, false otherwise
+*/
+bool parseCSVDouble(const CSVField &field, double &value) noexcept
+{
+	// strtod() needs a terminated string, and the field is in the middle of
+	// the buffer, so copy it to the stack (numbers are never this long)
+	char number[64];
+	const size_t length = field.end - field.begin;
+
+	if (length == 0 || length >= sizeof(number))
+	{
+		return false;
+	}
+
+	std::memcpy(number, field.begin, length);
+	number[length] = '\0';
+
+	char *parsed;
+	value = std::strtod(number, &parsed);
+
+	if (parsed == number)
+	{
+		return false;
+	}
+
+	while (*parsed != '\0' && std::isspace(static_cast<unsigned char>(*parsed)))
+	{
+		parsed++;
+	}
+
+	return *parsed == '\0';
+}
@@ -0,0 +1,68 @@
+#ifndef CSV_H_
+#define CSV_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the declarations for the CSV scanner shared by the CSV
+  parsers in Areas. CSVReader splits a buffer of CSV (e.g. the contents of an
+  InputMappedFile) into records and fields as defined by RFC 4180, including
+  quoted fields that contain commas, quotes or line breaks. Fields are
+  returned as ranges into the buffer, so nothing is copied unless needed.
+
+  Finding the next comma, quote or newline is the hot loop of parsing CSV, so
+  findCSVSpecial() checks 16 (SSE2) or 32 (AVX2) bytes at a time when the
+  compiler targets those instruction sets, and falls back to checking a byte
+  at a time otherwise.
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+  A field in a record of CSV, as a [begin, end) range into the buffer. For a
+  quoted field, the range excludes the surrounding quotes, and escaped is true
+  if it contains doubled ("") quotes that str() must unescape.
+*/
+struct CSVField
+{
+	const char *begin;
+	const char *end;
+	bool escaped;
+
+	bool empty() const noexcept;
+	std::string str() const;
+
+	bool operator==(const std::string &other) const;
+	bool operator!=(const std::string &other) const;
+};
+
+/*
+  Splits a buffer of CSV into records, one call to next() at a time. A record
+  ends at a line break outside of quotes; a '\r' before the '\n' is not part
+  of the last field.
+*/
+class CSVReader
+{
+private:
+	const char *pos;
+	const char *const end;
+
+public:
+	CSVReader(const char *begin, const char *end) noexcept;
+
+	bool next(std::vector<CSVField> &fields);
+};
+
+const char *findCSVSpecial(const char *begin, const char *end) noexcept;
+const char *findCSVSpecialScalar(const char *begin, const char *end) noexcept;
+
+bool parseCSVYear(const CSVField &field, unsigned int &year) noexcept;
+bool parseCSVDouble(const CSVField &field, double &value) noexcept;
+
+#endif // CSV_H_
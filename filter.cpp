@@ -0,0 +1,196 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the implementation of AreaFilterMatcher. See the header
+  file for additional comments.
+ */
+
+#include <cctype>
+#include <queue>
+
+#include "filter.h"
+
+// Auxiliary function to lowercase a byte as tolower() does in the "C" locale,
+// leaving any non-ASCII bytes (e.g. of UTF-8 names) unchanged
+static unsigned char lowercaseByte(unsigned char c) noexcept
+{
+	return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+/*
+  Constructor for an AreaFilterMatcher, compiling the filter strings into an
+  automaton.
+
+  @param filter
+	The areas filter, e.g. from BethYw::parseAreasArg(). If this is null or
+	empty, every value matches.
+
+  @example
+	auto areasFilter = BethYw::parseAreasArg(args);
+	AreaFilterMatcher matcher(&areasFilter);
+*/
+AreaFilterMatcher::AreaFilterMatcher(const std::unordered_set<std::string> *const filter)
+{
+	for (unsigned int c = 0; c < 256; c++)
+	{
+		this->byteClass[c] = 0;
+	}
+
+	if (filter == nullptr || filter->empty())
+	{
+		return;
+	}
+
+	this->empty = false;
+
+	// Give each byte used by the filter strings its own class. Uppercase bytes
+	// share the class of their lowercase equivalent.
+	for (auto &str : *filter)
+	{
+		for (unsigned char c : str)
+		{
+			unsigned char lower = lowercaseByte(c);
+			if (this->byteClass[lower] == 0)
+			{
+				this->byteClass[lower] = this->numClasses++;
+			}
+		}
+	}
+
+	for (unsigned int c = 'A'; c <= 'Z'; c++)
+	{
+		this->byteClass[c] = this->byteClass[lowercaseByte(c)];
+	}
+
+	// Build a trie of the filter strings. A transition of 0 (to the root) is
+	// missing until the failure links are added below.
+	this->transitions.assign(this->numClasses, 0);
+	this->accepting.assign(1, false);
+
+	for (auto &str : *filter)
+	{
+		unsigned int state = 0;
+
+		for (unsigned char c : str)
+		{
+			unsigned int &next = this->transitions[state * this->numClasses + this->byteClass[c]];
+
+			if (next == 0)
+			{
+				next = this->accepting.size();
+				this->accepting.push_back(false);
+				this->transitions.resize(this->transitions.size() + this->numClasses, 0);
+			}
+
+			state = this->transitions[state * this->numClasses + this->byteClass[c]];
+		}
+
+		this->accepting[state] = true;
+	}
+
+	// Complete the automaton breadth first: a missing transition goes where
+	// the longest proper suffix of the state (its failure link) would go, and
+	// a state accepts if its failure link does
+	std::vector<unsigned int> failure(this->accepting.size(), 0);
+	std::queue<unsigned int> queue;
+
+	for (unsigned int c = 0; c < this->numClasses; c++)
+	{
+		unsigned int next = this->transitions[c];
+		if (next != 0)
+		{
+			queue.push(next);
+		}
+	}
+
+	while (!queue.empty())
+	{
+		unsigned int state = queue.front();
+		queue.pop();
+
+		if (this->accepting[failure[state]])
+		{
+			this->accepting[state] = true;
+		}
+
+		for (unsigned int c = 0; c < this->numClasses; c++)
+		{
+			unsigned int &next = this->transitions[state * this->numClasses + c];
+			unsigned int fallback = this->transitions[failure[state] * this->numClasses + c];
+
+			if (next == 0)
+			{
+				next = fallback;
+			}
+			else
+			{
+				failure[next] = fallback;
+				queue.push(next);
+			}
+		}
+	}
+}
+
+/*
+  Check if the filter is empty, i.e. every value matches.
+
+  @return
+	true if there was no filter or it had no strings
+*/
+bool AreaFilterMatcher::matchesAll() const noexcept
+{
+	return this->empty;
+}
+
+/*
+  Check if any of the filter strings is a substring of [begin, end), ignoring
+  case. This does not allocate.
+
+  @param begin
+	The first character of the value
+
+  @param end
+	One past the last character of the value
+
+  @return
+	true if the value matches the filter (or the filter is empty)
+
+  @example
+	AreaFilterMatcher matcher(&areasFilter);
+
+	if (matcher.matches(field.begin, field.end)) {
+	  ...
+	}
+*/
+bool AreaFilterMatcher::matches(const char *begin, const char *end) const noexcept
+{
+	// The root only accepts if one of the filter strings is empty
+	if (this->empty || this->accepting[0])
+	{
+		return true;
+	}
+
+	unsigned int state = 0;
+	for (; begin != end; begin++)
+	{
+		state = this->transitions[state * this->numClasses + this->byteClass[static_cast<unsigned char>(*begin)]];
+
+		if (this->accepting[state])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool AreaFilterMatcher::matches(const std::string &value) const noexcept
+{
+	return this->matches(value.data(), value.data() + value.size());
+}
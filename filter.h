@@ -0,0 +1,50 @@
+#ifndef FILTER_H_
+#define FILTER_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the declaration of AreaFilterMatcher, which the parsers in
+  Areas use to check every row they import against the areas filter.
+
+  An area matches the filter if any of the filter strings is a substring of its
+  code or one of its names, ignoring case. Rather than searching for each
+  filter string in turn, the filter is compiled once into an Aho–Corasick
+  automaton, which finds any of them in a single pass over each value, without
+  lowercasing or copying it.
+ */
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class AreaFilterMatcher
+{
+private:
+	// Each byte is first mapped to a class: the bytes that appear (lowercased)
+	// in the filter strings have a class each, and all others share class 0.
+	// This keeps the transition table small.
+	unsigned char byteClass[256];
+	unsigned int numClasses = 1;
+
+	// The transitions of the automaton, numClasses per state, and whether
+	// reaching each state means a filter string has been found
+	std::vector<unsigned int> transitions;
+	std::vector<bool> accepting;
+
+	bool empty = true;
+
+public:
+	AreaFilterMatcher(const std::unordered_set<std::string> *const filter);
+
+	bool matchesAll() const noexcept;
+
+	bool matches(const char *begin, const char *end) const noexcept;
+	bool matches(const std::string &value) const noexcept;
+};
+
+#endif // FILTER_H_
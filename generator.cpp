@@ -0,0 +1,335 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the implementation of DatasetGenerator. See the header
+  file for additional comments.
+ */
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "generator.h"
+
+/*
+  Constructor for a DatasetGenerator.
+
+  @param options
+	The size and shape of the datasets to generate
+
+  @example
+	GeneratorOptions options;
+	options.authorities = 10000;
+
+	DatasetGenerator generator(options);
+*/
+DatasetGenerator::DatasetGenerator(const GeneratorOptions &options)
+	: options(options), random(options.seed) {}
+
+/*
+  Get the local authority code of a synthetic authority. The first 22 have
+  the same codes as the bundled datasets.
+
+  @param authority
+	The index of the authority, from 0
+
+  @return
+	The local authority code, e.g. W06000001 for authority 0
+*/
+std::string DatasetGenerator::authorityCode(unsigned int authority) const
+{
+	char code[16];
+	std::snprintf(code, sizeof(code), "W%08u", 6000001 + authority);
+	return code;
+}
+
+/*
+  Get the English or Welsh name of a synthetic authority. Some of the Welsh
+  names have a comma, quotes and a non-ASCII character, so that a CSV file of
+  them has quoted and escaped fields like the bundled areas.csv.
+
+  @param authority
+	The index of the authority, from 0
+
+  @param welsh
+	true for the Welsh name, false for the English name
+
+  @return
+	The name, e.g. Authority 1 or Awdurdod 1
+*/
+std::string DatasetGenerator::authorityName(unsigned int authority, bool welsh) const
+{
+	const std::string number = std::to_string(authority + 1);
+
+	if (!welsh)
+	{
+		return "Authority " + number;
+	}
+
+	if (authority % 5 == 4)
+	{
+		return "Awdurdod " + number + ", \"M\xC3\xB4n\"";
+	}
+
+	return "Awdurdod " + number;
+}
+
+// Auxiliary method to get the next pseudo-random value for a reading, which
+// grows from year to year (so that the statistics are not all zero) with
+// some noise
+double DatasetGenerator::nextValue(unsigned int authority, unsigned int measure, unsigned int year)
+{
+	const double base = 1000.0 * (authority + 1) + 100.0 * measure;
+	const double growth = 1.0 + 0.01 * (year - this->options.firstYear);
+	const double noise = 0.95 + 0.1 * (this->random() / 4294967296.0);
+
+	// Round to two decimal places, like most of the bundled values
+	return static_cast<long long>(base * growth * noise * 100) / 100.0;
+}
+
+// Auxiliary function to format a value for either format, to the two decimal
+// places nextValue() rounds to
+static std::string formatValue(double value)
+{
+	char formatted[32];
+	std::snprintf(formatted, sizeof(formatted), "%.2f", value);
+	return formatted;
+}
+
+// Auxiliary function to quote a CSV field if it needs to be, doubling any
+// quotes in it
+static std::string quoteCSVField(const std::string &field)
+{
+	if (field.find_first_of(",\"\r\n") == std::string::npos)
+	{
+		return field;
+	}
+
+	std::string quoted = "\"";
+	for (char c : field)
+	{
+		quoted += c;
+		if (c == '"')
+		{
+			quoted += '"';
+		}
+	}
+	quoted += '"';
+
+	return quoted;
+}
+
+/*
+  Write a list of local authorities, with their English and Welsh names, in
+  the format of areas.csv.
+
+  @param os
+	The stream to write the CSV to
+
+  @param source
+	The InputFileSource to take the column headings from, e.g.
+	BethYw::InputFiles::AREAS
+
+  @return
+	The number of rows (authorities) written
+
+  @example
+	std::ofstream os("generated/areas.csv");
+	generator.writeAuthorityCodeCSV(os, BethYw::InputFiles::AREAS);
+*/
+size_t DatasetGenerator::writeAuthorityCodeCSV(std::ostream &os, const BethYw::InputFileSource &source)
+{
+	os << quoteCSVField(source.COLS.at(BethYw::AUTH_CODE)) << ","
+	   << quoteCSVField(source.COLS.at(BethYw::AUTH_NAME_ENG)) << ","
+	   << quoteCSVField(source.COLS.at(BethYw::AUTH_NAME_CYM)) << "\n";
+
+	for (unsigned int authority = 0; authority < this->options.authorities; authority++)
+	{
+		os << this->authorityCode(authority) << ","
+		   << quoteCSVField(this->authorityName(authority, false)) << ","
+		   << quoteCSVField(this->authorityName(authority, true)) << "\n";
+	}
+
+	return this->options.authorities;
+}
+
+/*
+  Write a StatsWales JSON document with a row for every authority, measure
+  and year. A dataset with a single measure (i.e. SINGLE_MEASURE_CODE in its
+  columns) has no measure columns, and only one measure. Each row also has
+  the noise columns, and RowKey and PartitionKey, as the bundled files do.
+
+  @param os
+	The stream to write the JSON to
+
+  @param source
+	The InputFileSource to take the column headings from, e.g.
+	BethYw::InputFiles::POPDEN
+
+  @return
+	The number of rows written
+
+  @example
+	std::ofstream os("generated/popu1009.json");
+	generator.writeWelshStatsJSON(os, BethYw::InputFiles::POPDEN);
+*/
+size_t DatasetGenerator::writeWelshStatsJSON(std::ostream &os, const BethYw::InputFileSource &source)
+{
+	const auto &cols = source.COLS;
+	const bool singleMeasure = cols.find(BethYw::MEASURE_CODE) == cols.end();
+	const unsigned int measures = singleMeasure ? 1 : this->options.measures;
+
+	// The columns of each row as heading and JSON value pairs, in the order of
+	// the bundled files. More than one SourceColumn may share a heading (e.g.
+	// in envi0201.json), in which case the column is only written once
+	std::vector<std::pair<std::string, std::string>> row;
+	auto column = [&](const std::string &heading, const std::string &value)
+	{
+		for (auto &existing : row)
+		{
+			if (existing.first == heading)
+			{
+				return;
+			}
+		}
+		row.push_back(std::make_pair(heading, value));
+	};
+
+	size_t rows = 0;
+	os << "{\n  \"odata.metadata\":\"synthetic#" << source.CODE << "\",\"value\":[";
+
+	for (unsigned int authority = 0; authority < this->options.authorities; authority++)
+	{
+		for (unsigned int measure = 0; measure < measures; measure++)
+		{
+			for (unsigned int year = this->options.firstYear; year < this->options.firstYear + this->options.years; year++)
+			{
+				const std::string measureCode = "M" + std::to_string(measure + 1);
+
+				row.clear();
+				column(cols.at(BethYw::VALUE), formatValue(this->nextValue(authority, measure, year)));
+				column(cols.at(BethYw::AUTH_CODE), "\"" + this->authorityCode(authority) + "\"");
+				column(cols.at(BethYw::AUTH_NAME_ENG), "\"" + this->authorityName(authority, false) + "\"");
+				if (!singleMeasure)
+				{
+					column(cols.at(BethYw::MEASURE_CODE), "\"" + measureCode + "\"");
+					column(cols.at(BethYw::MEASURE_NAME), "\"Measure " + std::to_string(measure + 1) + "\"");
+				}
+				column(cols.at(BethYw::YEAR), "\"" + std::to_string(year) + "\"");
+
+				// Alternate between string and number noise
+				for (unsigned int noise = 0; noise < this->options.noiseColumns; noise++)
+				{
+					const std::string value = std::to_string(this->random() % 100000);
+					column("Noise" + std::to_string(noise + 1) + "_SortOrder", noise % 2 == 0 ? "\"" + value + "\"" : value);
+				}
+
+				char rowKey[20];
+				std::snprintf(rowKey, sizeof(rowKey), "\"%016zu\"", rows);
+				column("RowKey", rowKey);
+				column("PartitionKey", "\"\"");
+
+				os << (rows == 0 ? "\n    {\n      " : ",{\n      ");
+				for (size_t i = 0; i < row.size(); i++)
+				{
+					os << (i == 0 ? "\"" : ",\"") << row[i].first << "\":" << row[i].second;
+				}
+				os << "\n    }";
+
+				rows++;
+			}
+		}
+	}
+
+	os << "\n  ]\n}\n";
+	return rows;
+}
+
+/*
+  Write a table with the value of a single measure for every authority (the
+  rows) and year (the columns), in the format of complete-popu1009-pop.csv.
+  The authorities must have been imported first, e.g. from the file written
+  by writeAuthorityCodeCSV() with the same options.
+
+  @param os
+	The stream to write the CSV to
+
+  @param source
+	The InputFileSource to take the column headings from, e.g.
+	BethYw::InputFiles::COMPLETE_POP
+
+  @return
+	The number of rows (authorities) written
+
+  @example
+	std::ofstream os("generated/complete-popu1009-pop.csv");
+	generator.writeAuthorityByYearCSV(os, BethYw::InputFiles::COMPLETE_POP);
+*/
+size_t DatasetGenerator::writeAuthorityByYearCSV(std::ostream &os, const BethYw::InputFileSource &source)
+{
+	os << quoteCSVField(source.COLS.at(BethYw::AUTH_CODE));
+	for (unsigned int year = this->options.firstYear; year < this->options.firstYear + this->options.years; year++)
+	{
+		os << "," << year;
+	}
+	os << "\n";
+
+	for (unsigned int authority = 0; authority < this->options.authorities; authority++)
+	{
+		os << this->authorityCode(authority);
+		for (unsigned int year = this->options.firstYear; year < this->options.firstYear + this->options.years; year++)
+		{
+			os << "," << formatValue(this->nextValue(authority, 0, year));
+		}
+		os << "\n";
+	}
+
+	return this->options.authorities;
+}
+
+/*
+  Write a dataset in the format of its InputFileSource.
+
+  @param os
+	The stream to write the dataset to
+
+  @param source
+	The InputFileSource of the dataset, e.g. from BethYw::InputFiles::DATASETS
+
+  @return
+	The number of rows written
+
+  @throws
+	std::invalid_argument if the source is not a format that can be generated
+
+  @example
+	for (auto &source : BethYw::InputFiles::DATASETS) {
+	  std::ofstream os("generated/" + source.FILE);
+	  generator.write(os, source);
+	}
+*/
+size_t DatasetGenerator::write(std::ostream &os, const BethYw::InputFileSource &source)
+{
+	switch (source.PARSER)
+	{
+	case BethYw::AuthorityCodeCSV:
+		return this->writeAuthorityCodeCSV(os, source);
+
+	case BethYw::WelshStatsJSON:
+		return this->writeWelshStatsJSON(os, source);
+
+	case BethYw::AuthorityByYearCSV:
+		return this->writeAuthorityByYearCSV(os, source);
+
+	default:
+		throw std::invalid_argument("Cannot generate a dataset of type " + std::to_string(source.PARSER));
+	}
+}
@@ -0,0 +1,71 @@
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the declaration of DatasetGenerator, which writes
+  synthetic datasets in each of the formats Areas can import
+  (AuthorityCodeCSV, WelshStatsJSON and AuthorityByYearCSV) of any size, for
+  scale testing and benchmarks.
+
+  A dataset is written for an InputFileSource from datasets.h, using its
+  column headings, so that the file can be imported by bethyw (e.g. with
+  --dir pointing at the generated files) or a benchmark in place of the
+  bundled one. The values are pseudo-random, but the same for the same seed.
+ */
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+
+#include "datasets.h"
+
+/*
+  The size and shape of the datasets to generate.
+*/
+struct GeneratorOptions
+{
+	// The number of local authorities, W06000001 onwards
+	unsigned int authorities = 22;
+
+	// The number of measures in a dataset that has more than one
+	unsigned int measures = 2;
+
+	// The years of the readings, firstYear onwards
+	unsigned int firstYear = 1991;
+	unsigned int years = 29;
+
+	// The number of extra columns in each row of a WelshStatsJSON dataset
+	// that are not imported, like the *_SortOrder columns in the bundled files
+	unsigned int noiseColumns = 4;
+
+	std::uint32_t seed = 1;
+};
+
+class DatasetGenerator
+{
+private:
+	const GeneratorOptions options;
+	std::mt19937 random;
+
+	double nextValue(unsigned int authority, unsigned int measure, unsigned int year);
+
+public:
+	DatasetGenerator(const GeneratorOptions &options);
+
+	std::string authorityCode(unsigned int authority) const;
+	std::string authorityName(unsigned int authority, bool welsh) const;
+
+	size_t writeAuthorityCodeCSV(std::ostream &os, const BethYw::InputFileSource &source);
+	size_t writeWelshStatsJSON(std::ostream &os, const BethYw::InputFileSource &source);
+	size_t writeAuthorityByYearCSV(std::ostream &os, const BethYw::InputFileSource &source);
+	size_t write(std::ostream &os, const BethYw::InputFileSource &source);
+};
+
+#endif // GENERATOR_H_
@@ -19,6 +19,15 @@
 #include "input.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /*
   TODO: InputSource::InputSource(source)
@@ -91,4 +100,144 @@ std::istream &InputFile::open()
 	}
 
 	return file_stream;
-}
\ No newline at end of file
+}
+
+/*
+  Constructor for a memory-mapped file-based source. The file is not mapped
+  until open() is called.
+
+  @param path
+	The complete path for a file to import.
+
+  @example
+	InputMappedFile input("data/popu1009.json");
+*/
+InputMappedFile::InputMappedFile(const std::string &filePath)
+	: InputSource(filePath), data(nullptr), length(0) {}
+
+InputMappedFile::~InputMappedFile()
+{
+	this->close();
+}
+
+// Auxiliary method to unmap the file (if it is mapped)
+void InputMappedFile::close() noexcept
+{
+#ifndef _WIN32
+	if (this->data != nullptr && this->length > 0)
+	{
+		munmap(const_cast<char *>(this->data), this->length);
+	}
+#else
+	this->buffer.clear();
+#endif
+
+	this->data = nullptr;
+	this->length = 0;
+}
+
+/*
+  Map the file at the path retrievable from getSource() into memory. Its
+  contents are then available through begin() and end().
+
+  @throws
+	std::runtime_error if there is an issue opening or mapping the file, with
+	the message:
+	InputMappedFile::open: Failed to open file <file name>
+
+  @example
+	InputMappedFile input("data/popu1009.json");
+	input.open();
+	areas.populate(input.begin(), input.end(), ...);
+*/
+void InputMappedFile::open()
+{
+	// Unmap the file if open() was called previously
+	this->close();
+
+#ifndef _WIN32
+	int fd = ::open(this->getSource().c_str(), O_RDONLY);
+	struct stat info;
+
+	if (fd == -1 || fstat(fd, &info) == -1 || !S_ISREG(info.st_mode))
+	{
+		if (fd != -1)
+		{
+			::close(fd);
+		}
+
+		throw std::runtime_error("InputMappedFile::open: Failed to open file " + this->getSource());
+	}
+
+	// mmap() cannot map an empty file, but there is nothing to map anyway
+	if (info.st_size > 0)
+	{
+		void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (mapped == MAP_FAILED)
+		{
+			::close(fd);
+			throw std::runtime_error("InputMappedFile::open: Failed to open file " + this->getSource());
+		}
+
+		// The parsers read each file from start to finish
+		madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+
+		this->data = static_cast<const char *>(mapped);
+		this->length = info.st_size;
+	}
+
+	// The mapping stays valid once the descriptor is closed
+	::close(fd);
+#else
+	std::ifstream file_stream(this->getSource(), std::ios::binary);
+
+	if (file_stream.fail())
+	{
+		throw std::runtime_error("InputMappedFile::open: Failed to open file " + this->getSource());
+	}
+
+	std::ostringstream contents;
+	contents << file_stream.rdbuf();
+	this->buffer = contents.str();
+	this->data = this->buffer.data();
+	this->length = this->buffer.size();
+#endif
+}
+
+/*
+  Retrieve the start of the file's contents. This function should be callable
+  from a constant context.
+
+  @return
+	A pointer to the first byte of the file, or nullptr if it is empty or has
+	not been opened
+*/
+const char *InputMappedFile::begin() const noexcept
+{
+	return this->data;
+}
+
+/*
+  Retrieve the end of the file's contents. This function should be callable
+  from a constant context.
+
+  @return
+	A pointer to one past the last byte of the file
+*/
+const char *InputMappedFile::end() const noexcept
+{
+	return this->data + this->length;
+}
+
+/*
+  Retrieve the size of the file. This function should be callable from a
+  constant context.
+
+  @return
+	The number of bytes in the file
+*/
+std::size_t InputMappedFile::size() const noexcept
+{
+	return this->length;
+}
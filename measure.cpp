@@ -22,7 +22,9 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <vector>
 #include "measure.h"
+#include "view.h"
 
 /*
   TODO: Measure::Measure(codename, label);
@@ -43,12 +45,71 @@
 	std::string label = "Population";
 	Measure measure(codename, label);
 */
-Measure::Measure(std::string codename, const std::string label) : label(label)
-{
-	std::transform(codename.begin(), codename.end(), codename.begin(), ::tolower);
+Measure::Measure(std::string codename, const std::string label)
+	: codename(SymbolTable::fold(SymbolTable::intern(codename))),
+	  label(SymbolTable::intern(label)) {}
 
-	this->codename = codename;
-}
+/*
+  As above, but for a codename and label that have already been interned, e.g.
+  by an importer. The codename is still converted to lowercase.
+
+  @param codename
+	The Symbol of the codename for the measure
+
+  @param label
+	The Symbol of the label for the measure
+
+  @param alloc
+	The allocator for the readings, e.g. that of the Area the Measure will be
+	added to. By default, the readings are allocated from the heap.
+
+  @example
+	Measure measure(SymbolTable::intern("Pop"), SymbolTable::intern("Population"));
+*/
+Measure::Measure(Symbol codename, Symbol label, const allocator_type &alloc) noexcept
+	: codename(SymbolTable::fold(codename)),
+	  label(label),
+	  years(alloc),
+	  values(alloc) {}
+
+/*
+  Copy a Measure, allocating the readings of the copy with the given allocator,
+  e.g. to copy it into the Arena of an Areas object.
+
+  @param other
+	The Measure to copy
+
+  @param alloc
+	The allocator for the readings of the copy
+
+  @example
+	Measure copy(measure, area.getAllocator());
+*/
+Measure::Measure(const Measure &other, const allocator_type &alloc)
+	: codename(other.codename),
+	  label(other.label),
+	  years(other.years, alloc),
+	  values(other.values, alloc) {}
+
+/*
+  Move a Measure, allocating the readings with the given allocator. The
+  readings are only copied if they were allocated by a different allocator
+  (e.g. from the heap or another Arena).
+
+  @param other
+	The Measure to move
+
+  @param alloc
+	The allocator for the readings of the new Measure
+
+  @example
+	Measure moved(std::move(measure), area.getAllocator());
+*/
+Measure::Measure(Measure &&other, const allocator_type &alloc)
+	: codename(other.codename),
+	  label(other.label),
+	  years(std::move(other.years), alloc),
+	  values(std::move(other.values), alloc) {}
 
 /*
   TODO: Measure::getCodename()
@@ -70,6 +131,12 @@ Measure::Measure(std::string codename, const std::string label) : label(label)
 	auto codename2 = measure.getCodename();
 */
 const std::string &Measure::getCodename() const noexcept
+{
+	return SymbolTable::resolve(this->codename);
+}
+
+// Auxiliary method to get the Symbol of the codename, e.g. to key on it
+Symbol Measure::getCodenameSymbol() const noexcept
 {
 	return this->codename;
 }
@@ -95,6 +162,13 @@ const std::string &Measure::getCodename() const noexcept
 */
 
 const std::string &Measure::getLabel() const noexcept
+{
+	return SymbolTable::resolve(this->label);
+}
+
+// Auxiliary method to get the Symbol of the label, e.g. to copy it to another
+// Measure without looking it up again
+Symbol Measure::getLabelSymbol() const noexcept
 {
 	return this->label;
 }
@@ -114,6 +188,11 @@ const std::string &Measure::getLabel() const noexcept
 	measure.setLabel("New Population");
 */
 void Measure::setLabel(const std::string label)
+{
+	this->label = SymbolTable::intern(label);
+}
+
+void Measure::setLabel(Symbol label) noexcept
 {
 	this->label = label;
 }
@@ -146,11 +225,11 @@ void Measure::setLabel(const std::string label)
 */
 const double Measure::getValue(const unsigned int key) const
 {
-	auto element = this->values.find(key);
+	auto element = std::lower_bound(this->years.begin(), this->years.end(), key);
 
-	if (element != this->values.end())
+	if (element != this->years.end() && *element == key)
 	{
-		return element->second;
+		return this->values[element - this->years.begin()];
 	}
 
 	throw std::out_of_range("No value found for year " + std::to_string(key));
@@ -181,14 +260,26 @@ const double Measure::getValue(const unsigned int key) const
 
 void Measure::setValue(unsigned int year, double value)
 {
+	// Datasets are usually in chronological order, so appending is the
+	// common case and needs no search
+	if (this->years.empty() || year > this->years.back())
+	{
+		this->years.push_back(year);
+		this->values.push_back(value);
+		return;
+	}
 
-	if (this->values.find(year) != this->values.end())
+	auto element = std::lower_bound(this->years.begin(), this->years.end(), year);
+	auto index = element - this->years.begin();
+
+	if (*element == year)
 	{
-		this->values[year] = value;
+		this->values[index] = value;
 	}
 	else
 	{
-		this->values.insert(std::make_pair(year, value));
+		this->years.insert(element, year);
+		this->values.insert(this->values.begin() + index, value);
 	}
 }
 
@@ -212,7 +303,7 @@ void Measure::setValue(unsigned int year, double value)
 */
 const int Measure::size() const noexcept
 {
-	return this->values.size();
+	return this->years.size();
 }
 
 /*
@@ -240,11 +331,9 @@ const double Measure::getDifference() const noexcept
 		return 0;
 	}
 
-	// Years will sorted numerically by getAllYears
-	auto years = this->getAllYears();
-
-	double first_year = this->getValue(years[0]);
-	double last_year = this->getValue(years[years.size() - 1]);
+	// Years are kept sorted, so the first and last values are at either end
+	double first_year = this->values.front();
+	double last_year = this->values.back();
 
 	try
 	{
@@ -282,11 +371,9 @@ const double Measure::getDifferenceAsPercentage() const noexcept
 		return 0;
 	}
 
-	// Years will sorted numerically by getAllYears
-	auto years = this->getAllYears();
-
-	double first_year = this->getValue(years[0]);
-	double last_year = this->getValue(years[years.size() - 1]);
+	// Years are kept sorted, so the first and last values are at either end
+	double first_year = this->values.front();
+	double last_year = this->values.back();
 
 	// Cannot divide by zero
 	if (first_year == 0)
@@ -331,9 +418,9 @@ const double Measure::getAverage() const noexcept
 		return 0;
 	}
 
-	for (auto it = this->values.begin(); it != this->values.end(); it++)
+	for (size_t i = 0; i < this->values.size(); i++)
 	{
-		sum += it->second;
+		sum += this->values[i];
 	}
 
 	return sum / this->size();
@@ -341,21 +428,84 @@ const double Measure::getAverage() const noexcept
 
 // Auxiliary method to get all years sorted numerically
 // e.g. 1991 and 2010
-const std::vector<unsigned int> Measure::getAllYears() const noexcept
+const Measure::Years &Measure::getAllYears() const noexcept
 {
-	std::vector<unsigned int> keys;
-	for (auto it = this->values.begin(); it != this->values.end(); ++it)
-	{
-		keys.push_back(it->first);
+	// years is always kept in ascending order by setValue()
+	return this->years;
+}
+
+/*
+  Get an iterator to the first (i.e. earliest) reading in the Measure. Together
+  with end(), this lets the readings be walked in a range-based for loop
+  without copying them.
+
+  @return
+	An iterator to the first reading
+
+  @example
+	Measure measure("pop", "Population");
+	measure.setValue(1999, 12345678.9);
+
+	for (auto reading : measure) {
+	  std::cout << reading.year << ": " << reading.value << std::endl;
 	}
+*/
+Measure::const_iterator Measure::begin() const noexcept
+{
+	return const_iterator(this->years.data(), this->values.data());
+}
+
+/*
+  Get an iterator to one past the last reading in the Measure.
+
+  @return
+	An iterator to one past the last reading
+*/
+Measure::const_iterator Measure::end() const noexcept
+{
+	return const_iterator(this->years.data() + this->years.size(),
+						  this->values.data() + this->values.size());
+}
+
+/*
+  Get an iterator to the first reading in the Measure for the given year or
+  any later year, found by a binary search.
+
+  @param year
+	The earliest year to find a reading for
 
-	std::sort(keys.begin(), keys.end(),
-			  [](const unsigned int &a, const unsigned int &b) -> bool
-			  {
-				  return a < b;
-			  });
+  @return
+	An iterator to the first reading no earlier than year, or end() if there
+	is none
 
-	return keys;
+  @example
+	Measure measure("pop", "Population");
+	...
+	// The readings from 2000 to 2010
+	auto first = measure.lowerBound(2000);
+	auto last = measure.upperBound(2010);
+*/
+Measure::const_iterator Measure::lowerBound(unsigned int year) const noexcept
+{
+	auto index = std::lower_bound(this->years.begin(), this->years.end(), year) - this->years.begin();
+	return const_iterator(this->years.data() + index, this->values.data() + index);
+}
+
+/*
+  Get an iterator to the first reading in the Measure for a year after the
+  given year, found by a binary search.
+
+  @param year
+	The last year to skip the readings of
+
+  @return
+	An iterator to the first reading later than year, or end() if there is
+	none
+*/
+Measure::const_iterator Measure::upperBound(unsigned int year) const noexcept
+{
+	auto index = std::upper_bound(this->years.begin(), this->years.end(), year) - this->years.begin();
+	return const_iterator(this->years.data() + index, this->values.data() + index);
 }
 
 /*
@@ -394,57 +544,39 @@ const std::vector<unsigned int> Measure::getAllYears() const noexcept
 	measure.setValue(1999, 12345678.9);
 	std::cout << measure << std::end;
 */
-std::ostream &operator<<(std::ostream &os, Measure &measure)
+std::ostream &operator<<(std::ostream &os, const Measure &measure)
 {
+	std::string table;
+	appendTable(table, measure);
+	os.write(table.data(), table.size());
 
-	auto years = measure.getAllYears();
-
-	os << measure.getLabel() << " (" << measure.getCodename() << ")" << std::endl;
-
-	// If no data in measurement output "<no data>"
-	if (years.size() == 0)
-	{
-		os << "<no data>\n"
-		   << std::endl;
-
-		return os;
-	}
-
-	// Calculate number of spaces depending on the number of characters in
-	// year and the corresponding value
-	int space_count;
-	for (size_t i = 0; i < years.size(); i++)
-	{
-		space_count = std::to_string(measure.getValue(years[i])).size() - std::to_string(years[i]).size();
-
-		os << std::string(space_count, ' ') << std::to_string(years[i]) + " ";
-	}
-
-	space_count = std::to_string(measure.getAverage()).size() - std::string("Average").size();
-	os << std::string(space_count, ' ')
-	   << "Average ";
-
-	space_count = std::to_string(measure.getDifference()).size() - std::string("Diff.").size();
-	os << std::string(space_count, ' ')
-	   << "Diff. ";
+	return os;
+}
 
-	space_count = std::to_string(measure.getDifferenceAsPercentage()).size() - std::string("% Diff.").size();
-	os << std::string(space_count, ' ')
-	   << "% Diff." << std::endl;
+/*
+  Append the table that operator<< outputs for a Measure to a string, so that
+  the tables of many measures can be built up and written to a stream at once.
+  This is the table of a view of all of the Measure's readings.
 
-	for (size_t i = 0; i < years.size(); i++)
-	{
-		os << std::to_string(measure.getValue(years[i])) << " ";
-	}
+  @param out
+	The string to append the table to
 
-	os << std::to_string(measure.getAverage()) << " ";
-	os << std::to_string(measure.getDifference()) << " ";
-	os << std::to_string(measure.getDifferenceAsPercentage()) << std::endl;
+  @param measure
+	The Measure to output
 
-	os << std::endl;
+  @return
+	void
 
-	return os;
+  @example
+	std::string table;
+	appendTable(table, measure);
+	std::cout << table;
+*/
+void appendTable(std::string &out, const Measure &measure)
+{
+	appendTable(out, MeasureView(measure));
 }
+
 /*
   TODO: operator==(lhs, rhs)
 
@@ -463,27 +595,26 @@ std::ostream &operator<<(std::ostream &os, Measure &measure)
 */
 bool operator==(const Measure &m1, const Measure &m2)
 {
-	if (m1.getCodename() != m2.getCodename() ||
-		m1.getLabel() != m2.getLabel() ||
-		m1.size() != m2.size())
-	{
-		return false;
-	}
-
-	for (auto it = m1.getAllYears().begin(); it != m1.getAllYears().end(); it++)
-	{
-		try
-		{
-			if (m1.getValue(*it) != m2.getValue(*it))
-			{
-				return false;
-			}
-		}
-		catch (const std::out_of_range &e)
-		{
-			return false;
-		}
-	}
+	// The codename and label are interned, and the readings are kept sorted by
+	// year, so this is comparing two integers and then the two pairs of
+	// vectors element by element
+	return m1.codename == m2.codename &&
+		   m1.label == m2.label &&
+		   m1.years == m2.years &&
+		   m1.values == m2.values;
+}
 
-	return true;
+// Auxiliary function to get a lowercase copy of a string. Used to case-fold
+// keys once when they are stored, so that case-insensitive lookups can be
+// made with a single hash/ordered lookup instead of a strcasecmp scan. Only A-Z
+// are folded, as by the SymbolTable (see symbols.cpp), so the bytes above 0x7f
+// of UTF-8 names are left as they are and both agree on every key
+std::string toLowercase(std::string str) noexcept
+{
+	std::transform(str.begin(), str.end(), str.begin(),
+				   [](char c) -> char
+				   {
+					   return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+				   });
+	return str;
 }
\ No newline at end of file
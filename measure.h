@@ -14,10 +14,14 @@
   functions and member variables you need to declare in this class.
  */
 
+#include <cstddef>
+#include <iterator>
 #include <string>
-#include <map>
 #include <vector>
 
+#include "arena.h"
+#include "symbols.h"
+
 /*
   The Measure class contains a measure code, label, and a container for readings
   from across a number of years.
@@ -29,16 +33,118 @@
 class Measure
 {
 private:
-	std::string codename;
-	std::string label;
-	std::map<unsigned int, double> values;
+	// The codename (in lowercase) and label are interned in the SymbolTable
+	Symbol codename;
+	Symbol label;
+
+	// Readings are stored column-wise: years is kept sorted in ascending order
+	// and values[i] is the reading for years[i]. Both are contiguous, so the
+	// statistics below are linear scans rather than walks over tree nodes.
+	std::vector<unsigned int, ArenaAllocator<unsigned int>> years;
+	std::vector<double, ArenaAllocator<double>> values;
 
 public:
+	/*
+	  The allocator for the readings, which allocates from the Arena of the
+	  Areas object the Measure is in (or from the heap if it is in none).
+	*/
+	using allocator_type = ArenaAllocator<char>;
+
+	/*
+	  The years of the readings, as returned by getAllYears().
+	*/
+	using Years = std::vector<unsigned int, ArenaAllocator<unsigned int>>;
+
+	/*
+	  A single year's reading, as yielded when iterating over a Measure.
+	*/
+	struct Reading
+	{
+		unsigned int year;
+		double value;
+	};
+
+	/*
+	  An iterator over the readings of a Measure in chronological order. It
+	  reads straight from the Measure's storage, so iterating allocates
+	  nothing. It is invalidated by setValue().
+
+	  The years and values are stored apart, so dereferencing it builds a
+	  Reading rather than returning a reference to one. It is therefore only
+	  an input iterator (a forward iterator's reference must be a real
+	  reference), and operator-> returns a pointer proxy that holds the
+	  Reading.
+	*/
+	class const_iterator
+	{
+	private:
+		const unsigned int *year;
+		const double *value;
+
+	public:
+		// What operator-> returns, which holds the Reading it points to
+		class pointer
+		{
+		private:
+			Reading reading;
+
+		public:
+			explicit pointer(Reading reading) noexcept : reading(reading) {}
+
+			const Reading *operator->() const noexcept { return &this->reading; }
+		};
+
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Reading;
+		using difference_type = std::ptrdiff_t;
+		using reference = Reading;
+
+		const_iterator(const unsigned int *year, const double *value) noexcept
+			: year(year), value(value) {}
+
+		Reading operator*() const noexcept { return Reading{*year, *value}; }
+		pointer operator->() const noexcept { return pointer(**this); }
+
+		const_iterator &operator++() noexcept
+		{
+			++year;
+			++value;
+			return *this;
+		}
+
+		const_iterator operator++(int) noexcept
+		{
+			const_iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		const_iterator operator+(difference_type n) const noexcept { return const_iterator(year + n, value + n); }
+		difference_type operator-(const const_iterator &other) const noexcept { return year - other.year; }
+
+		bool operator==(const const_iterator &other) const noexcept { return year == other.year; }
+		bool operator!=(const const_iterator &other) const noexcept { return year != other.year; }
+	};
+
 	Measure(std::string code, const std::string label);
+	Measure(Symbol codename, Symbol label, const allocator_type &alloc = allocator_type()) noexcept;
+	Measure(const Measure &other) = default;
+
+	// As for an Area, a moved Measure keeps the allocator of the one it was
+	// moved from (see Area(Area &&other))
+	Measure(Measure &&other) noexcept = default;
+	Measure(const Measure &other, const allocator_type &alloc);
+	Measure(Measure &&other, const allocator_type &alloc);
+	Measure &operator=(const Measure &other) = default;
+	Measure &operator=(Measure &&other) noexcept = default;
+
 	const std::string &getCodename() const noexcept;
+	Symbol getCodenameSymbol() const noexcept;
 
 	const std::string &getLabel() const noexcept;
+	Symbol getLabelSymbol() const noexcept;
 	void setLabel(const std::string label);
+	void setLabel(Symbol label) noexcept;
 
 	const double getValue(const unsigned int key) const;
 	void setValue(unsigned int year, double value);
@@ -48,10 +154,19 @@ public:
 	const double getDifferenceAsPercentage() const noexcept;
 	const double getAverage() const noexcept;
 
-	const std::vector<unsigned int> getAllYears() const noexcept;
+	const Years &getAllYears() const noexcept;
+
+	const_iterator begin() const noexcept;
+	const_iterator end() const noexcept;
+	const_iterator lowerBound(unsigned int year) const noexcept;
+	const_iterator upperBound(unsigned int year) const noexcept;
 
 	friend bool operator==(const Measure &m1, const Measure &m2);
-	friend std::ostream &operator<<(std::ostream &os, Measure &measure);
+	friend std::ostream &operator<<(std::ostream &os, const Measure &measure);
 };
 
+void appendTable(std::string &out, const Measure &measure);
+
+std::string toLowercase(std::string str) noexcept;
+
 #endif // MEASURE_H_
\ No newline at end of file
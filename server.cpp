@@ -0,0 +1,529 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the implementation of the query server behind the
+  --serve argument. See the header file for additional comments.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "lib_cxxopts.hpp"
+
+#include "bethyw.h"
+#include "server.h"
+#include "view.h"
+
+// The largest request that is read, which is far more than any query needs
+static const size_t MAX_REQUEST_SIZE = 16384;
+
+// How long a client has, in milliseconds, to send the whole of its request and
+// to read the whole of the response, before the connection is closed
+static const int CONNECTION_DEADLINE_MS = 5000;
+
+// Auxiliary function to decode a URL query string component, i.e. %XX
+// escapes and + for a space
+static std::string decodeQueryComponent(const std::string &component)
+{
+	std::string decoded;
+	decoded.reserve(component.size());
+
+	for (size_t i = 0; i < component.size(); i++)
+	{
+		const char c = component[i];
+
+		if (c == '+')
+		{
+			decoded += ' ';
+		}
+		else if (c == '%')
+		{
+			if (i + 2 >= component.size() ||
+				!std::isxdigit(static_cast<unsigned char>(component[i + 1])) ||
+				!std::isxdigit(static_cast<unsigned char>(component[i + 2])))
+			{
+				throw std::invalid_argument("Invalid escape in query");
+			}
+
+			decoded += static_cast<char>(std::stoi(component.substr(i + 1, 2), nullptr, 16));
+			i += 2;
+		}
+		else
+		{
+			decoded += c;
+		}
+	}
+
+	return decoded;
+}
+
+/*
+  Parse the query string of a request URL into the arguments of a query. The
+  values are parsed by the same functions as the command line arguments, and
+  so are validated in the same way.
+
+  @param queryString
+	The query string, i.e. everything after the ? in the URL, e.g.
+	areas=swansea,cardiff&years=2000-2010&json
+
+  @return
+	The parsed query
+
+  @throws
+	std::invalid_argument if a parameter is not one of areas, measures, years
+	and json (or their short forms) or its value is invalid, with the same
+	message as for the command line argument
+
+  @example
+	auto query = BethYw::parseQuery("a=W06000011&m=pop&y=2010");
+*/
+BethYw::Query BethYw::parseQuery(const std::string &queryString)
+{
+	// Rebuild the command line for the query, e.g. --areas=swansea
+	std::vector<std::string> arguments = {"bethyw"};
+	Query query;
+
+	std::istringstream parameters(queryString);
+	std::string parameter;
+
+	while (std::getline(parameters, parameter, '&'))
+	{
+		if (parameter.empty())
+		{
+			continue;
+		}
+
+		const size_t equals = parameter.find('=');
+		const std::string name = decodeQueryComponent(parameter.substr(0, equals));
+		const std::string value = equals == std::string::npos ? "" : decodeQueryComponent(parameter.substr(equals + 1));
+
+		if (name == "json" || name == "j")
+		{
+			query.json = true;
+		}
+		else if (name == "areas" || name == "a")
+		{
+			arguments.push_back("--areas=" + value);
+		}
+		else if (name == "measures" || name == "m")
+		{
+			arguments.push_back("--measures=" + value);
+		}
+		else if (name == "years" || name == "y")
+		{
+			arguments.push_back("--years=" + value);
+		}
+		else
+		{
+			throw std::invalid_argument("Unknown query parameter: " + name);
+		}
+	}
+
+	std::vector<char *> argv;
+	for (auto &argument : arguments)
+	{
+		argv.push_back(&argument[0]);
+	}
+
+	int argc = static_cast<int>(argv.size());
+	char **argvData = argv.data();
+
+	auto cxxopts = BethYw::cxxoptsSetup();
+
+	try
+	{
+		auto args = cxxopts.parse(argc, argvData);
+
+		query.areasFilter = BethYw::parseAreasArg(args);
+		query.measuresFilter = BethYw::parseMeasuresArg(args);
+		query.yearsFilter = BethYw::parseYearsArg(args);
+	}
+	catch (const cxxopts::OptionException &e)
+	{
+		throw std::invalid_argument(e.what());
+	}
+
+	return query;
+}
+
+/*
+  Answer a query from the data in areas, in the format the command line with
+  the same arguments would print to the standard output.
+
+  @param areas
+	The Areas object with all the data
+
+  @param query
+	The query to answer
+
+  @return
+	The tables, or the JSON, for the selected data
+
+  @example
+	std::cout << BethYw::answerQuery(data, BethYw::parseQuery("a=swansea"));
+*/
+std::string BethYw::answerQuery(const Areas &areas, const Query &query)
+{
+	AreasView selection = areas.query(&query.areasFilter, &query.measuresFilter, &query.yearsFilter);
+
+	if (query.json)
+	{
+		return selection.toJSON() + "\n";
+	}
+
+	std::ostringstream tables;
+	tables << selection;
+	return tables.str();
+}
+
+// Auxiliary function to build an HTTP response
+static std::string httpResponse(const std::string &status, const std::string &contentType, const std::string &body)
+{
+	std::ostringstream response;
+	response << "HTTP/1.0 " << status << "\r\n"
+			 << "Content-Type: " << contentType << "\r\n"
+			 << "Content-Length: " << body.size() << "\r\n"
+			 << "Connection: close\r\n"
+			 << "\r\n"
+			 << body;
+
+	return response.str();
+}
+
+/*
+  Build the HTTP response to a request. Only GET requests for / (with a query
+  string, see parseQuery()) are answered.
+
+  @param areas
+	The Areas object with all the data
+
+  @param request
+	The request, or at least its request line, e.g.
+	GET /?areas=swansea HTTP/1.1
+
+  @return
+	The whole HTTP response, including the status line and headers. An
+	invalid query is answered with 400 Bad Request and any other error with
+	500 Internal Server Error, rather than an exception being thrown
+
+  @example
+	auto response = BethYw::respond(data, "GET /?a=swansea&j HTTP/1.0\r\n\r\n");
+*/
+std::string BethYw::respond(const Areas &areas, const std::string &request)
+{
+	const std::string text = "text/plain; charset=utf-8";
+
+	std::istringstream requestLine(request.substr(0, request.find("\r\n")));
+	std::string method, target, version;
+
+	if (!(requestLine >> method >> target >> version) || version.compare(0, 5, "HTTP/") != 0)
+	{
+		return httpResponse("400 Bad Request", text, "Malformed request\n");
+	}
+
+	if (method != "GET")
+	{
+		return httpResponse("405 Method Not Allowed", text, "Only GET is supported\n");
+	}
+
+	const size_t question = target.find('?');
+	if (target.substr(0, question) != "/")
+	{
+		return httpResponse("404 Not Found", text, "Not found: " + target + "\n");
+	}
+
+	try
+	{
+		Query query = BethYw::parseQuery(question == std::string::npos ? "" : target.substr(question + 1));
+
+		return httpResponse("200 OK",
+							query.json ? "application/json" : text,
+							BethYw::answerQuery(areas, query));
+	}
+	catch (const std::invalid_argument &e)
+	{
+		return httpResponse("400 Bad Request", text, std::string(e.what()) + "\n");
+	}
+	catch (const std::exception &e)
+	{
+		// e.g. std::bad_alloc, which must not stop the server
+		return httpResponse("500 Internal Server Error", text, std::string(e.what()) + "\n");
+	}
+}
+
+#ifndef _WIN32
+
+using Clock = std::chrono::steady_clock;
+
+// Auxiliary function to wait until a client is ready for events (POLLIN or
+// POLLOUT), or until the deadline. Returns whether the client is ready
+static bool waitForClient(int client, short events, Clock::time_point deadline)
+{
+	for (;;)
+	{
+		const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+		if (remaining.count() <= 0)
+		{
+			return false;
+		}
+
+		struct pollfd ready;
+		ready.fd = client;
+		ready.events = events;
+		ready.revents = 0;
+
+		const int polled = poll(&ready, 1, static_cast<int>(remaining.count()));
+		if (polled < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		return polled > 0;
+	}
+}
+
+// Auxiliary function to read a request from a client, up to the end of its
+// headers. If the whole request has not arrived by the deadline (however slowly
+// the client keeps sending it), nothing is returned
+static std::string readRequest(int client, Clock::time_point deadline)
+{
+	std::string request;
+	char buffer[4096];
+
+	while (request.size() < MAX_REQUEST_SIZE && request.find("\r\n\r\n") == std::string::npos)
+	{
+		if (!waitForClient(client, POLLIN, deadline))
+		{
+			return "";
+		}
+
+		ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+		if (received < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (received <= 0)
+		{
+			break;
+		}
+
+		request.append(buffer, received);
+	}
+
+	return request;
+}
+
+// Auxiliary function to write the whole of a response to a client, giving up
+// if the client has not read it all by the deadline. Each send() only writes
+// what fits in the socket's buffer, so that it never blocks past the deadline
+static void writeResponse(int client, const std::string &response, Clock::time_point deadline)
+{
+	size_t sent = 0;
+	while (sent < response.size())
+	{
+		if (!waitForClient(client, POLLOUT, deadline))
+		{
+			return;
+		}
+
+		ssize_t written = send(client, response.data() + sent, response.size() - sent, MSG_DONTWAIT);
+		if (written < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			continue;
+		}
+		if (written <= 0)
+		{
+			return;
+		}
+
+		sent += written;
+	}
+}
+
+// Auxiliary function to create a socket listening on address: a port on the
+// loopback interface if it is a number, or otherwise the path of a Unix domain
+// socket. Writes a description of where it is listening to description
+static int listenOn(const std::string &address, std::string &description)
+{
+	const bool isPort = !address.empty() && address.size() <= 5 &&
+						std::all_of(address.begin(), address.end(),
+									[](unsigned char c) { return std::isdigit(c) != 0; });
+
+	int listener;
+
+	if (isPort)
+	{
+		const unsigned long port = std::stoul(address);
+		if (port > 65535)
+		{
+			throw std::invalid_argument("Invalid input for serve argument");
+		}
+
+		listener = socket(AF_INET, SOCK_STREAM, 0);
+		if (listener < 0)
+		{
+			throw std::runtime_error("Cannot create socket: " + std::string(std::strerror(errno)));
+		}
+
+		int reuse = 1;
+		setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		struct sockaddr_in addr;
+		std::memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(static_cast<unsigned short>(port));
+
+		if (bind(listener, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0)
+		{
+			const std::string error = std::strerror(errno);
+			close(listener);
+			throw std::runtime_error("Cannot listen on port " + address + ": " + error);
+		}
+
+		// The port may have been chosen by the system (i.e. port 0)
+		socklen_t length = sizeof(addr);
+		getsockname(listener, reinterpret_cast<struct sockaddr *>(&addr), &length);
+		description = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/";
+	}
+	else
+	{
+		struct sockaddr_un addr;
+		std::memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+
+		if (address.empty() || address.size() >= sizeof(addr.sun_path))
+		{
+			throw std::invalid_argument("Invalid input for serve argument");
+		}
+		std::strncpy(addr.sun_path, address.c_str(), sizeof(addr.sun_path) - 1);
+
+		// Replace the socket of a previous server, but never any other file
+		struct stat info;
+		if (lstat(address.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+		{
+			unlink(address.c_str());
+		}
+
+		listener = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listener < 0)
+		{
+			throw std::runtime_error("Cannot create socket: " + std::string(std::strerror(errno)));
+		}
+
+		if (bind(listener, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0)
+		{
+			const std::string error = std::strerror(errno);
+			close(listener);
+			throw std::runtime_error("Cannot listen on " + address + ": " + error);
+		}
+
+		description = "unix:" + address;
+	}
+
+	if (listen(listener, SOMAXCONN) != 0)
+	{
+		const std::string error = std::strerror(errno);
+		close(listener);
+		throw std::runtime_error("Cannot listen on " + address + ": " + error);
+	}
+
+	return listener;
+}
+
+#endif
+
+/*
+  Answer queries from the data in areas until the process is stopped.
+
+  @param areas
+	The Areas object with all the data, which is not modified
+
+  @param address
+	A port number, to listen on 127.0.0.1 (0 to let the system choose one), or
+	the path of a Unix domain socket
+
+  @return
+	void (it only returns by throwing)
+
+  @throws
+	std::invalid_argument if the address is not a valid port or path with the
+	message: Invalid input for serve argument
+	std::runtime_error if the server cannot listen on address
+
+  @example
+	BethYw::loadAreas(data, dir, &areasFilter);
+	BethYw::loadDatasets(data, dir, datasetsToImport, ...);
+	BethYw::serve(data, "8080");
+*/
+void BethYw::serve(const Areas &areas, const std::string &address)
+{
+#ifdef _WIN32
+	(void)areas;
+	(void)address;
+	throw std::runtime_error("--serve is not supported on Windows");
+#else
+	std::string description;
+	const int listener = listenOn(address, description);
+
+	// A client that disconnects early must not stop the server
+	std::signal(SIGPIPE, SIG_IGN);
+
+	std::cerr << "Serving " << areas.size() << " areas on " << description << std::endl;
+
+	for (;;)
+	{
+		int client = accept(listener, nullptr, nullptr);
+		if (client < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+			{
+				continue;
+			}
+
+			const std::string error = std::strerror(errno);
+			close(listener);
+			throw std::runtime_error("Cannot accept connection: " + error);
+		}
+
+		// A client that never finishes its request, or never reads the
+		// response, is disconnected at the deadline, so it cannot hold up the
+		// others for long
+		const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(CONNECTION_DEADLINE_MS);
+
+		const std::string request = readRequest(client, deadline);
+		if (!request.empty())
+		{
+			writeResponse(client, BethYw::respond(areas, request), deadline);
+		}
+
+		close(client);
+	}
+#endif
+}
@@ -0,0 +1,66 @@
+#ifndef SERVER_H_
+#define SERVER_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the declarations of the query server behind the --serve
+  argument. The datasets are imported into an Areas object once, and then each
+  query selects from it (see Areas::query()) instead of importing the
+  datasets again, e.g.
+
+	./bin/bethyw --serve 8080 &
+	curl 'http://127.0.0.1:8080/?areas=swansea&years=2000-2010&json'
+
+  The server speaks a minimal HTTP/1.0 over either a TCP port on the loopback
+  interface or a Unix domain socket (curl --unix-socket). A query is a GET of
+  / with the same arguments as the command line, as URL query parameters:
+  areas (or a), measures (or m) and years (or y) with the same values, and
+  json (or j) for JSON instead of tables. The response is in the format the
+  command line would print to the standard output, or the error it would
+  print to the standard error with the status 400 (or 500 for an error that
+  is not the query's fault, e.g. running out of memory).
+
+  As the filters are applied to the merged data rather than to each row of
+  each dataset, an area is matched by any of its names (e.g. Abertawe) even
+  for the values of datasets that only have the codes of areas, and an area
+  that matches is listed even if none of its measures do.
+
+  Connections are answered one at a time, as a query takes microseconds. A
+  client has 5 seconds from connecting to send the whole of its request and
+  read the whole of the response, however slowly it keeps sending or reading,
+  and is then disconnected (without a response, if its request is not in
+  yet). So one connection holds up the others for at most 5 seconds.
+ */
+
+#include <string>
+
+#include "areas.h"
+
+namespace BethYw
+{
+
+	/*
+	  The arguments of a query, parsed from the URL of a request.
+	*/
+	struct Query
+	{
+		StringFilterSet areasFilter;
+		StringFilterSet measuresFilter;
+		YearFilterTuple yearsFilter;
+		bool json = false;
+	};
+
+	Query parseQuery(const std::string &queryString);
+	std::string answerQuery(const Areas &areas, const Query &query);
+	std::string respond(const Areas &areas, const std::string &request);
+
+	void serve(const Areas &areas, const std::string &address);
+
+} // namespace BethYw
+
+#endif // SERVER_H_
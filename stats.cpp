@@ -0,0 +1,428 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the implementation of the instrumentation behind the
+  --stats argument. See the header file for additional comments.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "stats.h"
+
+namespace
+{
+	using clock = std::chrono::steady_clock;
+
+	// When the process started (or near enough), which the start of each
+	// phase is relative to
+	const clock::time_point epoch = clock::now();
+
+	std::atomic<bool> statsEnabled(false);
+	std::atomic<std::uint64_t> counters[Stats::NUM_COUNTERS];
+
+	// The counts of the current thread. Counts is zero-initialised without a
+	// constructor, so this is safe to use from operator new (see
+	// allocations.cpp) on any thread
+	thread_local Stats::Counts threadCounters;
+
+	std::mutex phasesMutex;
+	std::vector<Stats::Phase> finished;
+
+	const char *const COUNTER_NAMES[Stats::NUM_COUNTERS] = {"rowsRead",
+															"rowsFilteredArea",
+															"rowsFilteredMeasure",
+															"rowsFilteredYear",
+															"bytesRead",
+															"allocations"};
+} // namespace
+
+/*
+  Start (or stop) recording statistics. Counts made while Stats is not enabled
+  are lost.
+
+  @param enabled
+	true to record statistics, false to stop recording them
+
+  @example
+	if (statsFormat != Stats::NONE) {
+	  Stats::enable();
+	}
+*/
+void Stats::enable(bool enabled) noexcept
+{
+	statsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+/*
+  Check whether statistics are being recorded, e.g. before doing extra work
+  (such as finding the size of a file) just to count something.
+
+  @return
+	true if Stats::enable() has been called
+*/
+bool Stats::enabled() noexcept
+{
+	return statsEnabled.load(std::memory_order_relaxed);
+}
+
+/*
+  Forget every phase and zero the total of every counter. The counts of other
+  threads are not zeroed, but they are only used as the difference between the
+  start and end of a phase.
+
+  @example
+	Stats::reset();
+	Stats::enable();
+	areas.populate(...);
+	auto rows = Stats::totals()[Stats::ROWS_READ];
+*/
+void Stats::reset()
+{
+	for (auto &counter : counters)
+	{
+		counter.store(0, std::memory_order_relaxed);
+	}
+
+	std::lock_guard<std::mutex> lock(phasesMutex);
+	finished.clear();
+}
+
+/*
+  Add to a counter, if statistics are being recorded.
+
+  @param counter
+	The counter to add to
+
+  @param n
+	The amount to add
+
+  @example
+	Stats::add(Stats::ROWS_READ, rowsRead);
+*/
+void Stats::add(Counter counter, std::uint64_t n) noexcept
+{
+	if (!Stats::enabled() || n == 0)
+	{
+		return;
+	}
+
+	threadCounters.values[counter] += n;
+	counters[counter].fetch_add(n, std::memory_order_relaxed);
+}
+
+/*
+  Get the total of each counter, over every thread.
+
+  @return
+	The totals
+
+  @example
+	auto allocations = Stats::totals()[Stats::ALLOCATIONS];
+*/
+Stats::Counts Stats::totals() noexcept
+{
+	Counts counts;
+	for (unsigned int i = 0; i < NUM_COUNTERS; i++)
+	{
+		counts.values[i] = counters[i].load(std::memory_order_relaxed);
+	}
+
+	return counts;
+}
+
+/*
+  Get what has been counted by the current thread.
+
+  @return
+	The counts of the current thread
+*/
+Stats::Counts Stats::threadCounts() noexcept
+{
+	return threadCounters;
+}
+
+/*
+  Get the phases that have finished, in the order they started.
+
+  @return
+	A copy of the phases
+*/
+std::vector<Stats::Phase> Stats::phases()
+{
+	std::vector<Phase> phases;
+	{
+		std::lock_guard<std::mutex> lock(phasesMutex);
+		phases = finished;
+	}
+
+	std::stable_sort(phases.begin(),
+					 phases.end(),
+					 [](const Phase &a, const Phase &b)
+					 { return a.start < b.start; });
+
+	return phases;
+}
+
+/*
+  Get the time since the process started.
+
+  @return
+	The time in seconds
+*/
+double Stats::elapsed() noexcept
+{
+	return std::chrono::duration<double>(clock::now() - epoch).count();
+}
+
+/*
+  Get the peak resident set size of the process, i.e. the most physical
+  memory it has used at once.
+
+  @return
+	The peak RSS in bytes, or 0 if it is not known on this platform
+*/
+std::uint64_t Stats::peakRSS() noexcept
+{
+#ifdef _WIN32
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+
+#ifdef __APPLE__
+	// macOS reports bytes, Linux kilobytes
+	return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+	return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// Auxiliary function to write the counters of a phase (or the totals) as a row
+// of the table written by writeText()
+static void writeTextRow(std::ostream &os, const std::string &name, double seconds, const Stats::Counts &counts)
+{
+	std::ostringstream filtered;
+	filtered << counts[Stats::ROWS_FILTERED_AREA] << '/'
+			 << counts[Stats::ROWS_FILTERED_MEASURE] << '/'
+			 << counts[Stats::ROWS_FILTERED_YEAR];
+
+	os << std::left << std::setw(32) << name << std::right
+	   << std::setw(12) << std::fixed << std::setprecision(3) << seconds * 1000
+	   << std::setw(12) << counts[Stats::ALLOCATIONS]
+	   << std::setw(12) << counts[Stats::ROWS_READ]
+	   << std::setw(24) << filtered.str()
+	   << std::setw(14) << counts[Stats::BYTES_READ] << std::endl;
+}
+
+/*
+  Write a table of the time taken by each phase and what was counted in it,
+  then the totals for the whole run so far and the peak RSS.
+
+  @param os
+	The stream to write to, e.g. std::cerr
+
+  @example
+	Stats::writeText(std::cerr);
+*/
+void Stats::writeText(std::ostream &os)
+{
+	std::ios_base::fmtflags flags = os.flags();
+	std::streamsize precision = os.precision();
+
+	os << std::left << std::setw(32) << "Phase" << std::right
+	   << std::setw(12) << "Time (ms)"
+	   << std::setw(12) << "Allocs"
+	   << std::setw(12) << "Rows read"
+	   << std::setw(24) << "Filtered (area/mea/yr)"
+	   << std::setw(14) << "Bytes read" << std::endl;
+
+	for (auto &phase : Stats::phases())
+	{
+		writeTextRow(os, phase.name, phase.seconds, phase.counts);
+	}
+
+	writeTextRow(os, "Total", Stats::elapsed(), Stats::totals());
+
+	const std::uint64_t rss = Stats::peakRSS();
+	os << "Peak RSS: ";
+	if (rss == 0)
+	{
+		os << "unknown" << std::endl;
+	}
+	else
+	{
+		os << std::setprecision(1) << rss / (1024.0 * 1024.0) << " MiB" << std::endl;
+	}
+
+	os.flags(flags);
+	os.precision(precision);
+}
+
+// Auxiliary function to write a string as a JSON string
+static void writeJSONString(std::ostream &os, const std::string &str)
+{
+	os << '"';
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			os << '\\' << c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			char escaped[8];
+			std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			os << escaped;
+		}
+		else
+		{
+			os << c;
+		}
+	}
+	os << '"';
+}
+
+// Auxiliary function to write the time and counters of a phase (or the
+// totals) as the members of a JSON object
+static void writeJSONCounts(std::ostream &os, double seconds, const Stats::Counts &counts)
+{
+	os << "\"seconds\":" << seconds;
+	for (unsigned int i = 0; i < Stats::NUM_COUNTERS; i++)
+	{
+		os << ",\"" << COUNTER_NAMES[i] << "\":" << counts.values[i];
+	}
+}
+
+/*
+  Write the same statistics as writeText() as a JSON object, e.g.
+
+	{"phases":[{"name":"arguments","start":0.001,"seconds":0.0002,
+	 "rowsRead":0,...},...],"total":{"seconds":0.05,...},"peakRSS":4194304}
+
+  The peak RSS is in bytes, and is null if it is not known.
+
+  @param os
+	The stream to write to, e.g. std::cerr
+
+  @example
+	Stats::writeJSON(std::cerr);
+*/
+void Stats::writeJSON(std::ostream &os)
+{
+	std::ios_base::fmtflags flags = os.flags();
+	std::streamsize precision = os.precision();
+	os << std::setprecision(9);
+
+	os << "{\"phases\":[";
+
+	bool first = true;
+	for (auto &phase : Stats::phases())
+	{
+		os << (first ? "{" : ",{") << "\"name\":";
+		writeJSONString(os, phase.name);
+		os << ",\"start\":" << phase.start << ',';
+		writeJSONCounts(os, phase.seconds, phase.counts);
+		os << '}';
+		first = false;
+	}
+
+	os << "],\"total\":{";
+	writeJSONCounts(os, Stats::elapsed(), Stats::totals());
+	os << "},\"peakRSS\":";
+
+	const std::uint64_t rss = Stats::peakRSS();
+	if (rss == 0)
+	{
+		os << "null";
+	}
+	else
+	{
+		os << rss;
+	}
+	os << '}' << std::endl;
+
+	os.flags(flags);
+	os.precision(precision);
+}
+
+/*
+  Constructor for a ScopedTimer, which starts timing a phase.
+
+  @param name
+	The name of the phase, e.g. the file being imported
+
+  @example
+	{
+	  Stats::ScopedTimer timer("output");
+	  std::cout << areas;
+	}
+*/
+Stats::ScopedTimer::ScopedTimer(const std::string &name)
+	: name(name), start(clock::now()), counts(Stats::threadCounts()), running(true) {}
+
+/*
+  Destructor for a ScopedTimer, which stops it if it has not been stopped
+  already.
+*/
+Stats::ScopedTimer::~ScopedTimer()
+{
+	this->stop();
+}
+
+/*
+  Stop timing the phase, and record it if statistics are being recorded.
+  Stopping a ScopedTimer again does nothing.
+
+  @example
+	Stats::ScopedTimer timer("arguments");
+	auto args = cxxopts.parse(argc, argv);
+	timer.stop();
+*/
+void Stats::ScopedTimer::stop()
+{
+	if (!this->running)
+	{
+		return;
+	}
+
+	this->running = false;
+	if (!Stats::enabled())
+	{
+		return;
+	}
+
+	const clock::time_point end = clock::now();
+	const Counts now = Stats::threadCounts();
+
+	Phase phase;
+	phase.name = this->name;
+	phase.start = std::chrono::duration<double>(this->start - epoch).count();
+	phase.seconds = std::chrono::duration<double>(end - this->start).count();
+	for (unsigned int i = 0; i < NUM_COUNTERS; i++)
+	{
+		phase.counts.values[i] = now.values[i] - this->counts.values[i];
+	}
+
+	std::lock_guard<std::mutex> lock(phasesMutex);
+	finished.push_back(std::move(phase));
+}
@@ -0,0 +1,126 @@
+#ifndef STATS_H_
+#define STATS_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the declarations of the instrumentation behind the
+  --stats argument: counters (e.g. of the rows read and filtered out by the
+  importers), timers for each phase of a run (e.g. importing a dataset) and
+  the process's heap allocations and peak resident set size.
+
+  Nothing is recorded until Stats::enable() is called, so that a run without
+  --stats pays only for a check of a flag. Counters are added to once per file
+  by the importers rather than once per row.
+
+  Counts are kept per thread as well as in total, so a phase (which starts and
+  stops on the same thread) has the counts of only its own work, even when
+  datasets are imported concurrently.
+
+  Heap allocations are counted by the replacement operator new in
+  allocations.cpp, which is linked into the bethyw program only, so that the
+  tests, benchmarks and other programs built on this code keep the default
+  operator new (and their ALLOCATIONS counter stays at zero).
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Stats
+{
+
+	/*
+	  The counters. A row is a row of a JSON dataset or CSV file, except that
+	  AuthorityByYearCSV files have a value for each year in a row, and so
+	  ROWS_FILTERED_YEAR counts those values. An AuthorityByYearCSV file whose
+	  (single) measure is filtered out is not read at all.
+	*/
+	enum Counter
+	{
+		ROWS_READ,
+		ROWS_FILTERED_AREA,
+		ROWS_FILTERED_MEASURE,
+		ROWS_FILTERED_YEAR,
+		BYTES_READ,
+		ALLOCATIONS,
+		NUM_COUNTERS
+	};
+
+	/*
+	  How to write the statistics at the end of a run: not at all, as a table,
+	  or as JSON.
+	*/
+	enum Format
+	{
+		NONE,
+		TEXT,
+		JSON
+	};
+
+	// The value of each counter, e.g. at the start of a phase
+	struct Counts
+	{
+		std::uint64_t values[NUM_COUNTERS] = {};
+
+		std::uint64_t operator[](Counter counter) const noexcept { return values[counter]; }
+	};
+
+	// A phase that has finished, and what it counted
+	struct Phase
+	{
+		std::string name;
+		double start;
+		double seconds;
+		Counts counts;
+	};
+
+	void enable(bool enabled = true) noexcept;
+	bool enabled() noexcept;
+	void reset();
+
+	void add(Counter counter, std::uint64_t n) noexcept;
+	Counts totals() noexcept;
+	Counts threadCounts() noexcept;
+
+	std::vector<Phase> phases();
+	double elapsed() noexcept;
+	std::uint64_t peakRSS() noexcept;
+
+	void writeText(std::ostream &os);
+	void writeJSON(std::ostream &os);
+
+	/*
+	  A timer for a phase of a run, which is recorded (with what was counted on
+	  this thread while it ran) when it is stopped or goes out of scope. A
+	  ScopedTimer that stops while Stats is not enabled records nothing, but
+	  one may be started before Stats is enabled (e.g. to time parsing the
+	  arguments that enable it).
+	*/
+	class ScopedTimer
+	{
+	private:
+		std::string name;
+		std::chrono::steady_clock::time_point start;
+		Counts counts;
+		bool running;
+
+	public:
+		ScopedTimer(const std::string &name);
+		~ScopedTimer();
+
+		ScopedTimer(const ScopedTimer &other) = delete;
+		ScopedTimer &operator=(const ScopedTimer &other) = delete;
+
+		void stop();
+	};
+
+} // namespace Stats
+
+#endif // STATS_H_
@@ -0,0 +1,374 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the implementation of the global symbol table. See the
+  header file for additional comments.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "symbols.h"
+
+namespace
+{
+
+	// Entries are stored in blocks that are allocated as the table grows and
+	// never moved, so that they can be read without locking while another
+	// thread adds to the table
+	const Symbol BLOCK_SIZE = 4096;
+	const Symbol MAX_BLOCKS = 4096;
+
+	struct Entry
+	{
+		std::string str;
+		Symbol folded;
+		std::size_t hash;
+	};
+
+	// An open-addressing hash index of the entries, which lookups read without
+	// locking. Each slot holds a Symbol plus one, or 0 if it is empty. An index
+	// is only added to while it is current: when it is half full, a new index
+	// twice the size is filled and then published in its place. The old index
+	// is kept, so a lookup still reading it is never left dangling
+	const std::size_t INITIAL_SLOTS = 1024;
+
+	struct Index
+	{
+		std::unique_ptr<std::atomic<Symbol>[]> slots;
+		std::size_t mask;
+
+		explicit Index(std::size_t size) : slots(new std::atomic<Symbol>[size]), mask(size - 1)
+		{
+			for (std::size_t i = 0; i < size; i++)
+			{
+				this->slots[i].store(0, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	struct Table
+	{
+		std::mutex mutex;
+		std::unique_ptr<Entry[]> blocks[MAX_BLOCKS];
+		Symbol size = 0;
+
+		std::atomic<const Index *> index{nullptr};
+		std::vector<std::unique_ptr<Index>> indexes;
+	};
+
+	// The table is created the first time it is used, so that it exists even
+	// if a string is interned during static initialisation
+	Table &table()
+	{
+		static Table instance;
+		return instance;
+	}
+
+	const Entry &entry(Symbol symbol) noexcept
+	{
+		return table().blocks[symbol / BLOCK_SIZE][symbol % BLOCK_SIZE];
+	}
+
+	// Each byte of a string as it is, or in lowercase for case-insensitive
+	// lookups. Only A-Z are folded, as by std::tolower() in the "C" locale the
+	// program runs in, so the bytes above 0x7f of names in UTF-8 (e.g. Ynys
+	// Môn) are left as they are, without a call into the locale for each byte
+	struct AsIs
+	{
+		char operator()(char c) const noexcept { return c; }
+	};
+
+	struct Lowercase
+	{
+		char operator()(char c) const noexcept
+		{
+			return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+		}
+	};
+
+	// Hash the bytes of a string (after passing each through fold) with
+	// FNV-1a, so that a string and its lowercase version can be hashed alike
+	// without copying it
+	template <typename Fold>
+	std::size_t hashString(const std::string &str, Fold fold) noexcept
+	{
+		std::uint64_t hash = 0xcbf29ce484222325ULL;
+		for (auto c : str)
+		{
+			hash = (hash ^ static_cast<unsigned char>(fold(c))) * 0x100000001b3ULL;
+		}
+
+		return static_cast<std::size_t>(hash);
+	}
+
+	// Find the Symbol for a string (after passing each byte through fold),
+	// without locking
+	template <typename Fold>
+	bool lookup(const Table &t, const std::string &str, Fold fold, Symbol &symbol) noexcept
+	{
+		const Index *index = t.index.load(std::memory_order_acquire);
+		if (index == nullptr)
+		{
+			return false;
+		}
+
+		const std::size_t hash = hashString(str, fold);
+		for (std::size_t i = hash & index->mask;; i = (i + 1) & index->mask)
+		{
+			const Symbol slot = index->slots[i].load(std::memory_order_acquire);
+			if (slot == 0)
+			{
+				return false;
+			}
+
+			const Entry &e = entry(slot - 1);
+			if (e.hash == hash && e.str.size() == str.size() &&
+				std::equal(str.begin(), str.end(), e.str.begin(),
+						   [&fold](char a, char b) { return fold(a) == b; }))
+			{
+				symbol = slot - 1;
+				return true;
+			}
+		}
+	}
+
+	// Add the entry for a Symbol to an index (with the mutex locked)
+	void insertSlot(Index &index, Symbol symbol) noexcept
+	{
+		std::size_t i = entry(symbol).hash & index.mask;
+		while (index.slots[i].load(std::memory_order_relaxed) != 0)
+		{
+			i = (i + 1) & index.mask;
+		}
+
+		index.slots[i].store(symbol + 1, std::memory_order_release);
+	}
+
+	// Add the newest entry to the index (with the mutex locked), first
+	// replacing the index with a bigger one if it would be over half full
+	void indexLocked(Table &t, Symbol symbol)
+	{
+		const Index *current = t.index.load(std::memory_order_relaxed);
+
+		if (current == nullptr || 2 * static_cast<std::size_t>(t.size) > current->mask + 1)
+		{
+			std::unique_ptr<Index> bigger(new Index(current == nullptr ? INITIAL_SLOTS : 2 * (current->mask + 1)));
+			for (Symbol existing = 0; existing < symbol; existing++)
+			{
+				insertSlot(*bigger, existing);
+			}
+
+			current = bigger.get();
+			t.indexes.push_back(std::move(bigger));
+			t.index.store(current, std::memory_order_release);
+		}
+
+		insertSlot(*t.indexes.back(), symbol);
+	}
+
+	// Add a string to the table (with the mutex locked), or get its Symbol if
+	// it is already there
+	Symbol internLocked(Table &t, const std::string &str)
+	{
+		Symbol existing;
+		if (lookup(t, str, AsIs(), existing))
+		{
+			return existing;
+		}
+
+		// Intern the lowercase version first, so that every entry knows its
+		// folded Symbol
+		std::string lower(str);
+		std::transform(lower.begin(), lower.end(), lower.begin(), Lowercase());
+
+		Symbol folded = lower == str ? t.size : internLocked(t, lower);
+		Symbol symbol = t.size;
+
+		if (symbol == BLOCK_SIZE * MAX_BLOCKS)
+		{
+			throw std::runtime_error("SymbolTable: too many distinct strings");
+		}
+
+		if (symbol % BLOCK_SIZE == 0)
+		{
+			t.blocks[symbol / BLOCK_SIZE].reset(new Entry[BLOCK_SIZE]);
+		}
+
+		t.blocks[symbol / BLOCK_SIZE][symbol % BLOCK_SIZE] = Entry{str, folded, hashString(str, AsIs())};
+		t.size++;
+
+		// Only once the entry is complete can lookups find it
+		indexLocked(t, symbol);
+
+		return symbol;
+	}
+
+} // namespace
+
+/*
+  Get the Symbol for a string, adding it to the table if it is new. The same
+  string always gives the same Symbol.
+
+  @param str
+	The string to intern
+
+  @return
+	The Symbol for str
+
+  @throws
+	std::runtime_error if the table is full
+
+  @example
+	Symbol code = SymbolTable::intern("W06000011");
+*/
+Symbol SymbolTable::intern(const std::string &str)
+{
+	Table &t = table();
+
+	// Only a new string needs the lock
+	Symbol symbol;
+	if (lookup(t, str, AsIs(), symbol))
+	{
+		return symbol;
+	}
+
+	std::lock_guard<std::mutex> lock(t.mutex);
+
+	return internLocked(t, str);
+}
+
+/*
+  Get the Symbol for a string if it has been interned, without adding it to the
+  table. This is for lookups, e.g. by a string from the command line: if a
+  string has never been interned, nothing can be stored under it.
+
+  @param str
+	The string to find
+
+  @param symbol
+	Set to the Symbol for str, if it is in the table
+
+  @return
+	true if str is in the table, false otherwise
+
+  @example
+	Symbol code;
+	if (SymbolTable::find("W06000011", code)) {
+	  ...
+	}
+*/
+bool SymbolTable::find(const std::string &str, Symbol &symbol)
+{
+	return lookup(table(), str, AsIs(), symbol);
+}
+
+/*
+  Get the Symbol for the lowercase version of a string if it has been
+  interned, without adding it to the table. This is for lookups of
+  case-insensitive keys (e.g. measure codenames), which are stored under their
+  folded Symbol.
+
+  The string is hashed and compared byte by byte as if it were in lowercase, so
+  it is never copied. Every string in the table has its lowercase version in
+  the table too, so if there is one, this finds it.
+
+  @param str
+	The string to find, in any case
+
+  @param symbol
+	Set to the Symbol for str in lowercase, if it is in the table
+
+  @return
+	true if str in lowercase is in the table, false otherwise
+
+  @example
+	Symbol key;
+	if (SymbolTable::findFolded("POP", key)) {
+	  // key == SymbolTable::intern("pop")
+	}
+*/
+bool SymbolTable::findFolded(const std::string &str, Symbol &symbol)
+{
+	return lookup(table(), str, Lowercase(), symbol);
+}
+
+/*
+  Get the string for a Symbol. The reference stays valid for the lifetime of
+  the program.
+
+  @param symbol
+	A Symbol returned by intern() or find()
+
+  @return
+	The interned string
+
+  @example
+	std::cout << SymbolTable::resolve(code);
+*/
+const std::string &SymbolTable::resolve(Symbol symbol) noexcept
+{
+	return entry(symbol).str;
+}
+
+/*
+  Get the Symbol for the lowercase version of the string of a Symbol, without
+  converting it again. Case-insensitive keys (e.g. measure codenames) are
+  stored under their folded Symbol.
+
+  @param symbol
+	A Symbol returned by intern() or find()
+
+  @return
+	The Symbol for the string in lowercase
+
+  @example
+	Symbol key = SymbolTable::fold(SymbolTable::intern("Pop"));
+	// key == SymbolTable::intern("pop")
+*/
+Symbol SymbolTable::fold(Symbol symbol) noexcept
+{
+	return entry(symbol).folded;
+}
+
+/*
+  Intern a string, reusing the Symbol of the previous string interned through
+  this cache if it is the same.
+
+  @param str
+	The string to intern
+
+  @return
+	The Symbol for str
+
+  @example
+	SymbolCache codes;
+
+	for (auto &row : rows) {
+	  Symbol code = codes.intern(row.code);
+	  ...
+	}
+*/
+Symbol SymbolCache::intern(const std::string &str)
+{
+	if (!this->valid || str != this->last)
+	{
+		this->symbol = SymbolTable::intern(str);
+		this->last = str;
+		this->valid = true;
+	}
+
+	return this->symbol;
+}
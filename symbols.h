@@ -0,0 +1,82 @@
+#ifndef SYMBOLS_H_
+#define SYMBOLS_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the declarations for the global symbol table, which
+  interns the strings that are repeated across the imported data: local
+  authority codes, names, language codes, and measure codenames and labels.
+
+  Each distinct string is stored once and identified by a Symbol, a small
+  integer. Area, Measure and Areas store and key on Symbols, so comparing and
+  hashing them is comparing and hashing integers, and the strings are only
+  looked up again when they are output.
+
+  Interning is thread-safe, so datasets can be imported concurrently. Only
+  adding a new string locks the table: finding a string that is already in it
+  (including interning it again) and resolving a Symbol back to its string do
+  not, as the string (and its entry in the table) never moves once it is
+  interned.
+ */
+
+#include <string>
+
+/*
+  An alias for an interned string.
+*/
+using Symbol = unsigned int;
+
+namespace SymbolTable
+{
+
+	/*
+	  Get the Symbol for a string, adding it to the table if it is new.
+	*/
+	Symbol intern(const std::string &str);
+
+	/*
+	  Get the Symbol for a string if it is in the table, without adding it.
+	*/
+	bool find(const std::string &str, Symbol &symbol);
+
+	/*
+	  As find(), but get the Symbol for the lowercase version of the string,
+	  for lookups of case-insensitive keys.
+	*/
+	bool findFolded(const std::string &str, Symbol &symbol);
+
+	/*
+	  Get the string for a Symbol.
+	*/
+	const std::string &resolve(Symbol symbol) noexcept;
+
+	/*
+	  Get the Symbol for the lowercase version of the string of a Symbol,
+	  which is the Symbol itself if the string is already lowercase.
+	*/
+	Symbol fold(Symbol symbol) noexcept;
+
+} // namespace SymbolTable
+
+/*
+  Remembers the last string interned through it and its Symbol. The importers
+  keep one for each column, as consecutive rows mostly repeat the same values,
+  so most rows are interned without locking the table.
+*/
+class SymbolCache
+{
+private:
+	std::string last;
+	Symbol symbol = 0;
+	bool valid = false;
+
+public:
+	Symbol intern(const std::string &str);
+};
+
+#endif // SYMBOLS_H_
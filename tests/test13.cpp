@@ -0,0 +1,120 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../csv.h"
+#include "../datasets.h"
+#include "../areas.h"
+
+SCENARIO( "CSVReader splits CSV into records and fields as in RFC 4180", "[CSV]" ) {
+
+  std::vector<CSVField> fields;
+
+  GIVEN( "CSV with quoted fields containing commas, quotes, and line breaks" ) {
+
+    const std::string csv = "a,\"b, c\",\"say \"\"hi\"\"\"\r\n"
+                            "\"multi\nline\",,e\n"
+                            "f";
+    CSVReader reader(csv.data(), csv.data() + csv.size());
+
+    THEN( "each record is read with its fields unquoted and unescaped" ) {
+
+      REQUIRE( reader.next(fields) );
+      REQUIRE( fields.size() == 3 );
+      REQUIRE( fields[0].str() == "a" );
+      REQUIRE( fields[1].str() == "b, c" );
+      REQUIRE( fields[2].str() == "say \"hi\"" );
+      REQUIRE( fields[2] == "say \"hi\"" );
+
+      REQUIRE( reader.next(fields) );
+      REQUIRE( fields.size() == 3 );
+      REQUIRE( fields[0].str() == "multi\nline" );
+      REQUIRE( fields[1].empty() );
+      REQUIRE( fields[2].str() == "e" );
+
+      REQUIRE( reader.next(fields) );
+      REQUIRE( fields.size() == 1 );
+      REQUIRE( fields[0].str() == "f" );
+
+      REQUIRE_FALSE( reader.next(fields) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "CSV with an unterminated quoted field" ) {
+
+    const std::string csv = "a,\"b\n";
+    CSVReader reader(csv.data(), csv.data() + csv.size());
+
+    THEN( "reading it throws a std::runtime_error" ) {
+
+      REQUIRE_THROWS_AS( reader.next(fields), std::runtime_error );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "findCSVSpecial finds the same characters as findCSVSpecialScalar", "[CSV]" ) {
+
+  GIVEN( "buffers with special characters at every offset up to 100 bytes" ) {
+
+    THEN( "the vectorised and scalar scanners agree" ) {
+
+      const char specials[] = {',', '"', '\n'};
+
+      for (size_t length = 0; length < 100; length++) {
+        for (size_t offset = 0; offset <= length; offset++) {
+          for (auto special : specials) {
+            std::string buffer(length, 'x');
+            if (offset < length) {
+              buffer[offset] = special;
+            }
+
+            const char *begin = buffer.data();
+            const char *end = buffer.data() + buffer.size();
+            REQUIRE( findCSVSpecial(begin, end) == findCSVSpecialScalar(begin, end) );
+          }
+        }
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "areas.csv names containing commas can be parsed", "[Areas][CSV]" ) {
+
+  GIVEN( "an areas.csv with a quoted Welsh name containing a comma" ) {
+
+    std::istringstream stream("Local authority code,Name (eng),Name (cym)\n"
+                              "W06000001,Isle of Anglesey,\"Ynys Môn, Sir Fôn\"\n");
+    Areas areas = Areas();
+
+    THEN( "the name is imported without the quotes" ) {
+
+      REQUIRE_NOTHROW( areas.populateFromAuthorityCodeCSV(stream, BethYw::InputFiles::AREAS.COLS) );
+      REQUIRE( areas.size() == 1 );
+      REQUIRE( areas.getArea("W06000001").getName("cym") == "Ynys Môn, Sir Fôn" );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
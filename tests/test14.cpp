@@ -0,0 +1,161 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../input.h"
+
+SCENARIO( "an Areas instance can be saved to and loaded from a snapshot", "[Areas][snapshot]" ) {
+
+  GIVEN( "an Areas instance populated from areas.csv and popu1009.json" ) {
+
+    Areas areas = Areas();
+
+    InputFile areasFile("datasets/areas.csv");
+    areas.populateFromAuthorityCodeCSV(areasFile.open(), BethYw::InputFiles::AREAS.COLS);
+
+    InputFile popdenFile("datasets/popu1009.json");
+    areas.populateFromWelshStatsJSON(popdenFile.open(), BethYw::InputFiles::DATASETS[0].COLS, nullptr, nullptr, nullptr);
+
+    std::stringstream snapshot;
+    areas.writeSnapshot(snapshot);
+
+    WHEN( "the snapshot is loaded into a new Areas instance" ) {
+
+      Areas loaded = Areas();
+      loaded.readSnapshot(snapshot);
+
+      THEN( "it has the same areas, names, and measures" ) {
+
+        REQUIRE( loaded.size() == areas.size() );
+        REQUIRE( loaded.getAllAuthorityCodes() == areas.getAllAuthorityCodes() );
+
+        for (auto &code : areas.getAllAuthorityCodes()) {
+          REQUIRE( loaded.getArea(code) == areas.getArea(code) );
+        }
+
+      } // THEN
+
+      THEN( "it produces the same JSON" ) {
+
+        REQUIRE( loaded.toJSON() == areas.toJSON() );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "a truncated snapshot is loaded" ) {
+
+      std::string truncated = snapshot.str();
+      truncated.resize(truncated.size() / 2);
+      std::istringstream is(truncated);
+
+      THEN( "a std::runtime_error is thrown" ) {
+
+        Areas loaded = Areas();
+        REQUIRE_THROWS_AS( loaded.readSnapshot(is), std::runtime_error );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "a snapshot with trailing data is loaded" ) {
+
+      std::istringstream is(snapshot.str() + snapshot.str());
+
+      THEN( "a std::runtime_error is thrown" ) {
+
+        Areas loaded = Areas();
+        REQUIRE_THROWS_AS( loaded.readSnapshot(is), std::runtime_error );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "something other than a snapshot is loaded" ) {
+
+      std::istringstream is("Local authority code,Name (eng),Name (cym)\n");
+
+      THEN( "a std::runtime_error is thrown" ) {
+
+        Areas loaded = Areas();
+        REQUIRE_THROWS_AS( loaded.readSnapshot(is), std::runtime_error );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "the snapshot of an import is saved for the datasets and files it was imported from", "[Areas][snapshot]" ) {
+
+  const std::string dir = std::string("datasets") + DIR_SEP;
+  const std::vector<BethYw::InputFileSource> popden = {BethYw::InputFiles::DATASETS[0]};
+  const std::vector<BethYw::InputFileSource> biz = {BethYw::InputFiles::DATASETS[1]};
+
+  GIVEN( "the signatures of imports of different datasets" ) {
+
+    const std::string signature = BethYw::snapshotSignature(dir, popden);
+
+    THEN( "they differ" ) {
+
+      REQUIRE_FALSE( signature.empty() );
+      REQUIRE( signature == BethYw::snapshotSignature(dir, popden) );
+      REQUIRE( signature != BethYw::snapshotSignature(dir, biz) );
+
+    } // THEN
+
+    THEN( "there is none for a dataset file that cannot be found" ) {
+
+      REQUIRE( BethYw::snapshotSignature(std::string("nowhere") + DIR_SEP, popden).empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a snapshot saved to a file" ) {
+
+    Areas areas = Areas();
+    InputFile popdenFile("datasets/popu1009.json");
+    areas.populateFromWelshStatsJSON(popdenFile.open(), BethYw::InputFiles::DATASETS[0].COLS, nullptr, nullptr, nullptr);
+
+    const std::string path = "test14.snapshot";
+    const std::string signature = BethYw::snapshotSignature(dir, popden);
+    BethYw::saveSnapshot(areas, path, signature);
+
+    THEN( "it is loaded for the same signature only" ) {
+
+      Areas loaded = Areas();
+      REQUIRE( BethYw::loadSnapshot(loaded, path, signature) );
+      REQUIRE( loaded.toJSON() == areas.toJSON() );
+
+      Areas other = Areas();
+      REQUIRE_FALSE( BethYw::loadSnapshot(other, path, BethYw::snapshotSignature(dir, biz)) );
+      REQUIRE( other.size() == 0 );
+
+    } // THEN
+
+    std::remove(path.c_str());
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,103 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../filter.h"
+#include "../areas.h"
+
+// Auxiliary function to match a value against a filter one string at a time,
+// as the areas filter was originally implemented
+static bool matchesNaively(const StringFilterSet &filter, std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+
+  for (auto str : filter) {
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+    if (value.find(str) != std::string::npos) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+SCENARIO( "AreaFilterMatcher finds any of the filter strings in a value, ignoring case", "[AreaFilterMatcher]" ) {
+
+  GIVEN( "no filter, or an empty filter" ) {
+
+    StringFilterSet filter;
+
+    THEN( "every value matches" ) {
+
+      REQUIRE( AreaFilterMatcher(nullptr).matchesAll() );
+      REQUIRE( AreaFilterMatcher(&filter).matchesAll() );
+      REQUIRE( AreaFilterMatcher(&filter).matches("W06000011") );
+      REQUIRE( AreaFilterMatcher(&filter).matches("") );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a filter of overlapping codes and names in mixed case" ) {
+
+    StringFilterSet filter = {"she", "HE", "hers", "W0600001", "Môn", "swan"};
+    AreaFilterMatcher matcher(&filter);
+
+    THEN( "it does not match everything" ) {
+
+      REQUIRE_FALSE( matcher.matchesAll() );
+
+    } // THEN
+
+    THEN( "it agrees with searching for each filter string in turn" ) {
+
+      const std::vector<std::string> values = {
+        "", "h", "sh", "ushers", "HIS", "W06000011", "w06000001", "W06000024",
+        "Isle of Anglesey", "Ynys Môn", "Ynys MÔn", "Swansea", "Abertawe",
+        "sWANSEA", "Cardiff", "ahishers", "W0600000"
+      };
+
+      for (auto &value : values) {
+        REQUIRE( matcher.matches(value) == matchesNaively(filter, value) );
+      }
+
+    } // THEN
+
+    THEN( "it matches a value given as a range of characters" ) {
+
+      const std::string row = "W06000011,Swansea,Abertawe";
+
+      REQUIRE( matcher.matches(row.data(), row.data() + 9) );
+      REQUIRE_FALSE( matcher.matches(row.data() + 18, row.data() + row.size()) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a filter containing an empty string" ) {
+
+    StringFilterSet filter = {"", "cardiff"};
+    AreaFilterMatcher matcher(&filter);
+
+    THEN( "every value matches, as an empty string is a substring of any value" ) {
+
+      REQUIRE( matcher.matches("Swansea") );
+      REQUIRE( matcher.matches("") );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
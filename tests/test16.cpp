@@ -0,0 +1,122 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include "../lib_json.hpp"
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../input.h"
+
+// Auxiliary function to build the JSON of an Areas instance as a json object,
+// as Areas::toJSON() originally did
+static std::string toJSONObject(Areas &areas) {
+  if (areas.size() == 0) {
+    return "{}";
+  }
+
+  nlohmann::json j;
+
+  for (auto &code : areas.getAllAuthorityCodes()) {
+    Area &area = areas.getArea(code);
+
+    for (auto &codename : area.getAllMeasureCodenames()) {
+      for (auto reading : area.getMeasure(codename)) {
+        j[code]["measures"][codename][std::to_string(reading.year)] = reading.value;
+      }
+    }
+
+    for (auto &lang : area.getAllNames()) {
+      j[code]["names"][lang] = area.getName(lang);
+    }
+  }
+
+  return j.dump();
+}
+
+SCENARIO( "Areas::writeJSON() streams the same JSON as dumping a json object", "[Areas][writeJSON]" ) {
+
+  GIVEN( "an Areas instance populated from areas.csv and popu1009.json" ) {
+
+    Areas areas = Areas();
+
+    InputFile areasFile("datasets/areas.csv");
+    areas.populateFromAuthorityCodeCSV(areasFile.open(), BethYw::InputFiles::AREAS.COLS);
+
+    InputFile popdenFile("datasets/popu1009.json");
+    areas.populateFromWelshStatsJSON(popdenFile.open(), BethYw::InputFiles::DATASETS[0].COLS, nullptr, nullptr, nullptr);
+
+    THEN( "the JSON is the same" ) {
+
+      std::ostringstream os;
+      areas.writeJSON(os);
+
+      REQUIRE( os.str() == toJSONObject(areas) );
+      REQUIRE( areas.toJSON() == toJSONObject(areas) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an Areas instance with unusual names, years, and values" ) {
+
+    Areas areas = Areas();
+
+    Area named("W06000999");
+    named.setName("eng", "Quote \" backslash \\ tab \t newline \n bell \a");
+    named.setName("cym", "Ynys Môn");
+
+    Measure measure("Test", "Test measure");
+    measure.setValue(999, -0.0);
+    measure.setValue(1000, 1e300);
+    measure.setValue(2000, 0.1);
+    measure.setValue(10000, std::nan(""));
+    named.setMeasure("test", measure);
+
+    Measure empty("empty", "No readings");
+    named.setMeasure("empty", empty);
+
+    areas.setArea("W06000999", named);
+
+    Area unnamed("W06000998");
+    Measure single("pop", "Population");
+    single.setValue(2010, 12345);
+    unnamed.setMeasure("pop", single);
+    areas.setArea("W06000998", unnamed);
+
+    areas.setArea("W06000997", Area("W06000997"));
+
+    THEN( "the JSON is the same" ) {
+
+      REQUIRE( areas.toJSON() == toJSONObject(areas) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an Areas instance with no areas" ) {
+
+    Areas areas = Areas();
+
+    THEN( "the JSON is an empty object" ) {
+
+      REQUIRE( areas.toJSON() == "{}" );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,183 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../symbols.h"
+#include "../area.h"
+
+SCENARIO( "the SymbolTable interns each distinct string once", "[SymbolTable]" ) {
+
+  GIVEN( "a string interned twice" ) {
+
+    Symbol first = SymbolTable::intern("Test symbol W06000011");
+    Symbol second = SymbolTable::intern(std::string("Test symbol ") + "W06000011");
+
+    THEN( "both give the same Symbol, which resolves to the string" ) {
+
+      REQUIRE( first == second );
+      REQUIRE( SymbolTable::resolve(first) == "Test symbol W06000011" );
+
+    } // THEN
+
+    THEN( "it folds to the Symbol of its lowercase version" ) {
+
+      Symbol lower = SymbolTable::intern("test symbol w06000011");
+
+      REQUIRE( SymbolTable::fold(first) == lower );
+      REQUIRE( SymbolTable::fold(lower) == lower );
+
+    } // THEN
+
+    THEN( "it can be found without interning it again" ) {
+
+      Symbol found;
+      REQUIRE( SymbolTable::find("Test symbol W06000011", found) );
+      REQUIRE( found == first );
+
+    } // THEN
+
+    THEN( "it and any other case of it can be found folded to lowercase" ) {
+
+      Symbol lower = SymbolTable::intern("test symbol w06000011");
+      Symbol found;
+
+      REQUIRE( SymbolTable::findFolded("Test symbol W06000011", found) );
+      REQUIRE( found == lower );
+      REQUIRE( SymbolTable::findFolded("TEST SYMBOL W06000011", found) );
+      REQUIRE( found == lower );
+      REQUIRE( SymbolTable::findFolded("test symbol w06000011", found) );
+      REQUIRE( found == lower );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a name in UTF-8 with bytes above 0x7f" ) {
+
+    Symbol name = SymbolTable::intern("Test symbol Ynys Môn");
+
+    THEN( "only its ASCII letters are folded" ) {
+
+      REQUIRE( SymbolTable::resolve(SymbolTable::fold(name)) == "test symbol ynys môn" );
+      REQUIRE( toLowercase("Test symbol Ynys Môn") == "test symbol ynys môn" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a string that has never been interned" ) {
+
+    THEN( "it cannot be found" ) {
+
+      Symbol found;
+      REQUIRE_FALSE( SymbolTable::find("Test symbol never interned", found) );
+      REQUIRE_FALSE( SymbolTable::findFolded("Test symbol never interned", found) );
+      REQUIRE_FALSE( SymbolTable::findFolded("test symbol never interned", found) );
+
+    } // THEN
+
+    THEN( "an Area has no measure with that codename" ) {
+
+      Area area("W06000011");
+      REQUIRE_THROWS_AS( area.getMeasure("Test symbol never interned either"), std::out_of_range );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "the same strings interned by several threads at once" ) {
+
+    const unsigned int numThreads = 4;
+    const unsigned int numStrings = 5000;
+    std::vector<std::vector<Symbol>> symbols(numThreads, std::vector<Symbol>(numStrings));
+    std::vector<std::thread> threads;
+
+    for (unsigned int t = 0; t < numThreads; t++) {
+      threads.push_back(std::thread([&symbols, t]() {
+        for (unsigned int i = 0; i < numStrings; i++) {
+          symbols[t][i] = SymbolTable::intern("Test thread symbol " + std::to_string(i));
+        }
+      }));
+    }
+
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    THEN( "every thread gets the same Symbol for each string" ) {
+
+      unsigned int mismatches = 0;
+
+      for (unsigned int i = 0; i < numStrings; i++) {
+        for (unsigned int t = 1; t < numThreads; t++) {
+          mismatches += symbols[t][i] != symbols[0][i];
+        }
+        mismatches += SymbolTable::resolve(symbols[0][i]) != "Test thread symbol " + std::to_string(i);
+      }
+
+      REQUIRE( mismatches == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "strings looked up by several threads while another adds to the table" ) {
+
+    const unsigned int numReaders = 3;
+    const unsigned int numStrings = 2000;
+    std::vector<Symbol> interned(numStrings);
+    for (unsigned int i = 0; i < numStrings; i++) {
+      interned[i] = SymbolTable::intern("Test lookup symbol " + std::to_string(i));
+    }
+
+    std::vector<unsigned int> misses(numReaders, 0);
+    std::vector<std::thread> threads;
+
+    // Enough new strings that the table's index is replaced several times
+    threads.push_back(std::thread([]() {
+      for (unsigned int i = 0; i < 50000; i++) {
+        SymbolTable::intern("Test added symbol " + std::to_string(i));
+      }
+    }));
+
+    for (unsigned int t = 0; t < numReaders; t++) {
+      threads.push_back(std::thread([&interned, &misses, t]() {
+        for (unsigned int round = 0; round < 20; round++) {
+          for (unsigned int i = 0; i < numStrings; i++) {
+            Symbol found;
+            misses[t] += !SymbolTable::find("Test lookup symbol " + std::to_string(i), found) || found != interned[i];
+            misses[t] += !SymbolTable::findFolded("TEST LOOKUP SYMBOL " + std::to_string(i), found) ||
+                         found != SymbolTable::fold(interned[i]);
+          }
+        }
+      }));
+    }
+
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    THEN( "every string already in the table is always found" ) {
+
+      for (auto count : misses) {
+        REQUIRE( count == 0 );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
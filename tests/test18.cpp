@@ -0,0 +1,157 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../arena.h"
+#include "../areas.h"
+
+SCENARIO( "an Arena allocates aligned memory from its blocks", "[Arena]" ) {
+
+  GIVEN( "an Arena" ) {
+
+    Arena arena;
+
+    THEN( "each allocation is aligned and does not overlap the last" ) {
+
+      char *a = static_cast<char *>(arena.allocate(3, 1));
+      double *b = static_cast<double *>(arena.allocate(sizeof(double), alignof(double)));
+
+      REQUIRE( reinterpret_cast<std::uintptr_t>(b) % alignof(double) == 0 );
+      REQUIRE( (reinterpret_cast<char *>(b) >= a + 3 || reinterpret_cast<char *>(b) + sizeof(double) <= a) );
+
+    } // THEN
+
+    THEN( "an allocation larger than a block is allocated on its own" ) {
+
+      std::vector<char, ArenaAllocator<char>> big{ArenaAllocator<char>(&arena)};
+      big.resize(4 * 1024 * 1024, 'x');
+
+      REQUIRE( big.size() == 4 * 1024 * 1024 );
+      REQUIRE( big.back() == 'x' );
+
+    } // THEN
+
+    THEN( "a small allocation that is freed is reused by the next one of the same size" ) {
+
+      void *a = arena.allocate(40, alignof(double));
+      void *b = arena.allocate(40, alignof(double));
+      arena.deallocate(a, 40, alignof(double));
+
+      // Not the most recent allocation, so reused from its size class
+      REQUIRE( arena.allocate(48, alignof(int)) == a );
+      REQUIRE( reinterpret_cast<std::uintptr_t>(b) % alignof(double) == 0 );
+
+    } // THEN
+
+    THEN( "the buffers a growing vector frees are reused by the next vector" ) {
+
+      // Something else (of another size) is allocated after each buffer, as
+      // in an import, so that no buffer is freed while it is the most recent
+      // allocation
+      std::set<const int *> freed;
+      std::vector<int, ArenaAllocator<int>> first{ArenaAllocator<int>(&arena)};
+      for (size_t capacity = 1; capacity <= 8; capacity *= 2) {
+        first.reserve(capacity);
+        freed.insert(first.data());
+        arena.allocate(100, alignof(double));
+      }
+
+      std::vector<int, ArenaAllocator<int>> second{ArenaAllocator<int>(&arena)};
+      for (size_t capacity = 1; capacity <= 4; capacity *= 2) {
+        second.reserve(capacity);
+        REQUIRE( freed.count(second.data()) == 1 );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "Area and Measure objects copied out of an Areas do not use its Arena", "[Arena]" ) {
+
+  GIVEN( "an Areas object with an Area and Measure" ) {
+
+    std::unique_ptr<Area> copy;
+
+    {
+      Areas areas;
+
+      Area area(SymbolTable::intern("W06000099"), areas.getAllocator());
+      area.setName("eng", "Test arena area");
+
+      Measure measure(SymbolTable::intern("pop"), SymbolTable::intern("Population"), areas.getAllocator());
+      measure.setValue(2020, 1.5);
+      area.setMeasure("pop", measure);
+
+      areas.setArea("W06000099", std::move(area));
+
+      copy.reset(new Area(areas.getArea("W06000099")));
+
+      REQUIRE( areas.getArea("W06000099").getAllocator().arena != nullptr );
+
+    }
+
+    THEN( "the copy outlives the Areas object" ) {
+
+      REQUIRE( copy->getAllocator().arena == nullptr );
+      REQUIRE( copy->getName("eng") == "Test arena area" );
+      REQUIRE( copy->getMeasure("pop").getValue(2020) == 1.5 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "Area objects moved out of an Areas use its Arena unless moved to the heap", "[Arena]" ) {
+
+  GIVEN( "an Areas object with an Area and Measure" ) {
+
+    std::unique_ptr<Area> moved;
+
+    {
+      Areas areas;
+
+      Area area(SymbolTable::intern("W06000099"), areas.getAllocator());
+      Measure measure(SymbolTable::intern("pop"), SymbolTable::intern("Population"), areas.getAllocator());
+      measure.setValue(2020, 1.5);
+      area.setMeasure("pop", measure);
+      areas.setArea("W06000099", std::move(area));
+
+      THEN( "a plain move keeps the Arena's allocator" ) {
+
+        Area kept(std::move(areas.getArea("W06000099")));
+        REQUIRE( kept.getAllocator() == areas.getAllocator() );
+
+      } // THEN
+
+      moved.reset(new Area(std::move(areas.getArea("W06000099")), Area::allocator_type()));
+
+    }
+
+    THEN( "a move with a default allocator outlives the Areas object" ) {
+
+      REQUIRE( moved->getAllocator().arena == nullptr );
+      REQUIRE( moved->getMeasure("pop").getValue(2020) == 1.5 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,89 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+
+#include "../areas.h"
+
+SCENARIO( "values can be upserted into an Areas instance", "[Areas][upsertValue]" ) {
+
+  GIVEN( "a newly constructed Areas instance" ) {
+
+    Areas areas = Areas();
+
+    WHEN( "a value is upserted for an area that does not exist" ) {
+
+      areas.upsertValue("W06000011", "pop", "Population", 2015, 1.5).setName("eng", "Swansea");
+
+      THEN( "the Area and Measure are created with the value" ) {
+
+        REQUIRE( areas.size() == 1 );
+        REQUIRE( areas.getArea("W06000011").getName("eng") == "Swansea" );
+        REQUIRE( areas.getArea("W06000011").getMeasure("pop").getLabel() == "Population" );
+        REQUIRE( areas.getArea("W06000011").getMeasure("pop").getValue(2015) == 1.5 );
+
+      } // THEN
+
+      AND_WHEN( "more values are upserted for the same area with a differently cased code" ) {
+
+        areas.upsertValue("w06000011", "POP", "Population estimate", 2014, 2.5);
+        areas.upsertValue("W06000011", "pop", "Population estimate", 2015, 3.5);
+
+        THEN( "they are written into the existing Area and Measure" ) {
+
+          Measure &measure = areas.getArea("W06000011").getMeasure("pop");
+
+          REQUIRE( areas.size() == 1 );
+          REQUIRE( areas.getArea("W06000011").size() == 1 );
+          REQUIRE( areas.getArea("W06000011").getLocalAuthorityCode() == "W06000011" );
+          REQUIRE( measure.getLabel() == "Population estimate" );
+          REQUIRE( measure.size() == 2 );
+          REQUIRE( measure.getValue(2014) == 2.5 );
+          REQUIRE( measure.getValue(2015) == 3.5 );
+
+        } // THEN
+
+      } // AND_WHEN
+
+    } // WHEN
+
+    WHEN( "the same values are set with setArea" ) {
+
+      Areas upserted = Areas();
+      upserted.upsertValue("W06000011", "pop", "Population", 2015, 1.5).setName("eng", "Swansea");
+      upserted.upsertValue("W06000011", "dens", "Density", 2015, 4.5);
+
+      Area area("W06000011");
+      area.setName("eng", "Swansea");
+
+      Measure pop("pop", "Population");
+      pop.setValue(2015, 1.5);
+      area.setMeasure("pop", pop);
+
+      Measure dens("dens", "Density");
+      dens.setValue(2015, 4.5);
+      area.setMeasure("dens", dens);
+
+      areas.setArea("W06000011", area);
+
+      THEN( "both give an equal Area" ) {
+
+        REQUIRE( upserted.getArea("W06000011") == areas.getArea("W06000011") );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
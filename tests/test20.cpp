@@ -0,0 +1,98 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../generator.h"
+
+SCENARIO( "generated datasets can be imported with the columns in datasets.h", "[DatasetGenerator]" ) {
+
+  GIVEN( "a DatasetGenerator for 30 authorities, 3 measures and 5 years" ) {
+
+    GeneratorOptions options;
+    options.authorities = 30;
+    options.measures = 3;
+    options.firstYear = 2000;
+    options.years = 5;
+    options.noiseColumns = 3;
+
+    DatasetGenerator generator(options);
+
+    Areas areas = Areas();
+
+    std::stringstream codes;
+    REQUIRE( generator.write(codes, BethYw::InputFiles::AREAS) == 30 );
+    areas.populate(codes, BethYw::AuthorityCodeCSV, BethYw::InputFiles::AREAS.COLS, nullptr, nullptr, nullptr);
+
+    THEN( "every authority is imported with its names, including quoted ones" ) {
+
+      REQUIRE( areas.size() == 30 );
+      REQUIRE( areas.getArea("W06000030").getName("eng") == "Authority 30" );
+      REQUIRE( areas.getArea("W06000005").getName("cym") == "Awdurdod 5, \"M\xC3\xB4n\"" );
+
+    } // THEN
+
+    THEN( "every dataset is imported with a value for each authority, measure and year" ) {
+
+      for (auto &source : BethYw::InputFiles::DATASETS) {
+        std::stringstream dataset;
+        const size_t rows = generator.write(dataset, source);
+
+        const bool multipleMeasures = source.COLS.find(BethYw::MEASURE_CODE) != source.COLS.end();
+        const bool json = source.PARSER == BethYw::WelshStatsJSON;
+
+        REQUIRE( rows == (json ? 30 * 5 * (multipleMeasures ? 3 : 1) : 30) );
+
+        Areas imported = Areas();
+        std::stringstream copy(codes.str());
+        imported.populate(copy, BethYw::AuthorityCodeCSV, BethYw::InputFiles::AREAS.COLS, nullptr, nullptr, nullptr);
+        imported.populate(dataset, source.PARSER, source.COLS, nullptr, nullptr, nullptr);
+
+        REQUIRE( imported.size() == 30 );
+
+        Area &area = imported.getArea("W06000017");
+        const std::string measure = multipleMeasures ? "m3" : source.COLS.at(BethYw::SINGLE_MEASURE_CODE);
+
+        REQUIRE( area.size() == (multipleMeasures ? 3 : 1) );
+        REQUIRE( area.getMeasure(measure).size() == 5 );
+        REQUIRE( area.getMeasure(measure).getValue(2004) > 0 );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "two DatasetGenerators with the same options" ) {
+
+    GeneratorOptions options;
+    options.authorities = 5;
+
+    DatasetGenerator first(options);
+    DatasetGenerator second(options);
+
+    THEN( "they generate the same dataset" ) {
+
+      std::ostringstream a, b;
+      first.write(a, BethYw::InputFiles::POPDEN);
+      second.write(b, BethYw::InputFiles::POPDEN);
+
+      REQUIRE( a.str() == b.str() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
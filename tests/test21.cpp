@@ -0,0 +1,196 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../lib_cxxopts.hpp"
+#include "../lib_cxxopts_argv.hpp"
+#include "../lib_json.hpp"
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../input.h"
+#include "../stats.h"
+
+SCENARIO( "the --stats argument can be parsed", "[Stats][args]" ) {
+
+  GIVEN( "no --stats argument" ) {
+
+    Argv argv({"test"});
+    auto** actual_argv = argv.argv();
+    auto argc          = argv.argc();
+
+    auto cxxopts = BethYw::cxxoptsSetup();
+    auto args    = cxxopts.parse(argc, actual_argv);
+
+    THEN( "no statistics are printed" ) {
+
+      REQUIRE( BethYw::parseStatsArg(args) == Stats::NONE );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "--stats with no value" ) {
+
+    Argv argv({"test", "--stats"});
+    auto** actual_argv = argv.argv();
+    auto argc          = argv.argc();
+
+    auto cxxopts = BethYw::cxxoptsSetup();
+    auto args    = cxxopts.parse(argc, actual_argv);
+
+    THEN( "the statistics are printed as a table" ) {
+
+      REQUIRE( BethYw::parseStatsArg(args) == Stats::TEXT );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "--stats=JSON" ) {
+
+    Argv argv({"test", "--stats=JSON"});
+    auto** actual_argv = argv.argv();
+    auto argc          = argv.argc();
+
+    auto cxxopts = BethYw::cxxoptsSetup();
+    auto args    = cxxopts.parse(argc, actual_argv);
+
+    THEN( "the statistics are printed as JSON" ) {
+
+      REQUIRE( BethYw::parseStatsArg(args) == Stats::JSON );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "--stats=xml" ) {
+
+    Argv argv({"test", "--stats=xml"});
+    auto** actual_argv = argv.argv();
+    auto argc          = argv.argc();
+
+    auto cxxopts = BethYw::cxxoptsSetup();
+    auto args    = cxxopts.parse(argc, actual_argv);
+
+    THEN( "an invalid argument exception is thrown" ) {
+
+      REQUIRE_THROWS_AS( BethYw::parseStatsArg(args), std::invalid_argument );
+      REQUIRE_THROWS_WITH( BethYw::parseStatsArg(args), "Invalid input for stats argument" );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "importing a dataset counts the rows read and filtered out", "[Stats][populate]" ) {
+
+  Stats::reset();
+  Stats::enable();
+
+  GIVEN( "popu1009.json, imported for two areas and the years 2000 to 2009" ) {
+
+    InputMappedFile input("datasets/popu1009.json");
+    input.open();
+
+    const StringFilterSet areasFilter = {"W06000011", "W06000015"};
+    const StringFilterSet measuresFilter = {"pop"};
+    const YearFilterTuple yearsFilter = std::make_tuple(2000, 2009);
+
+    Areas areas = Areas();
+    Stats::ScopedTimer timer("import popu1009.json");
+    areas.populate(input.begin(),
+                   input.end(),
+                   BethYw::WelshStatsJSON,
+                   BethYw::InputFiles::POPDEN.COLS,
+                   &areasFilter,
+                   &measuresFilter,
+                   &yearsFilter);
+    timer.stop();
+
+    const Stats::Counts totals = Stats::totals();
+
+    THEN( "every row is read, and each filtered out row is counted by the first filter it fails" ) {
+
+      REQUIRE( totals[Stats::ROWS_READ] == 1000 );
+      REQUIRE( totals[Stats::ROWS_FILTERED_AREA] == 913 );
+      REQUIRE( totals[Stats::ROWS_FILTERED_MEASURE] == 58 );
+      REQUIRE( totals[Stats::ROWS_FILTERED_YEAR] == 19 );
+
+      // Exactly the rows that passed every filter were imported
+      REQUIRE( areas.getArea("W06000011").getMeasure("pop").size() == 10 );
+
+    } // THEN
+
+    THEN( "the phase is recorded with what was counted while it ran" ) {
+
+      auto phases = Stats::phases();
+
+      REQUIRE( phases.size() == 1 );
+      REQUIRE( phases[0].name == "import popu1009.json" );
+      REQUIRE( phases[0].seconds >= 0 );
+      REQUIRE( phases[0].counts[Stats::ROWS_READ] == totals[Stats::ROWS_READ] );
+
+    } // THEN
+
+    THEN( "the statistics can be written as JSON" ) {
+
+      std::stringstream os;
+      Stats::writeJSON(os);
+
+      auto json = nlohmann::json::parse(os.str());
+
+      REQUIRE( json["phases"].size() == 1 );
+      REQUIRE( json["phases"][0]["name"] == "import popu1009.json" );
+      REQUIRE( json["total"]["rowsRead"] == totals[Stats::ROWS_READ] );
+      REQUIRE( json["total"]["rowsFilteredYear"] == totals[Stats::ROWS_FILTERED_YEAR] );
+
+    } // THEN
+
+  } // GIVEN
+
+  Stats::enable(false);
+  Stats::reset();
+
+  GIVEN( "statistics are not being recorded" ) {
+
+    InputMappedFile input("datasets/popu1009.json");
+    input.open();
+
+    Areas areas = Areas();
+    Stats::ScopedTimer timer("import popu1009.json");
+    areas.populate(input.begin(),
+                   input.end(),
+                   BethYw::WelshStatsJSON,
+                   BethYw::InputFiles::POPDEN.COLS,
+                   nullptr,
+                   nullptr,
+                   nullptr);
+    timer.stop();
+
+    THEN( "nothing is counted or recorded" ) {
+
+      REQUIRE( Stats::totals()[Stats::ROWS_READ] == 0 );
+      REQUIRE( Stats::phases().empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
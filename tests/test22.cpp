@@ -0,0 +1,114 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+#include <tuple>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../stats.h"
+
+SCENARIO( "JSON rows are filtered before their values are decoded", "[Areas][WelshStatsJSON][filters]" ) {
+
+  // Two rows with the year before the other columns, and one with the
+  // columns in the usual order. The values of the rows for W06000002 and
+  // for 2001 cannot be decoded
+  const std::string json =
+    "{\"value\":["
+    "{\"Year_Code\":\"2001\",\"Data\":\"not a number\",\"Localauthority_Code\":\"W06000001\","
+    "\"Localauthority_ItemName_ENG\":\"Isle of Anglesey\",\"Measure_Code\":\"Pop\","
+    "\"Measure_ItemName_ENG\":\"Population\"},"
+    "{\"Year_Code\":\"2000\",\"Data\":12.5,\"Localauthority_Code\":\"W06000001\","
+    "\"Localauthority_ItemName_ENG\":\"Isle of Anglesey\",\"Measure_Code\":\"Pop\","
+    "\"Measure_ItemName_ENG\":\"Population\"},"
+    "{\"Data\":\"?\",\"Localauthority_Code\":\"W06000002\","
+    "\"Localauthority_ItemName_ENG\":\"Gwynedd\",\"Measure_Code\":\"Dens\","
+    "\"Measure_ItemName_ENG\":\"Density\",\"Year_Code\":\"2000\"}"
+    "]}";
+
+  const auto &cols = BethYw::InputFiles::POPDEN.COLS;
+
+  GIVEN( "filters that keep only the readable row" ) {
+
+    const StringFilterSet areasFilter = {"W06000001"};
+    const StringFilterSet measuresFilter = {"pop"};
+    const YearFilterTuple yearsFilter = std::make_tuple(2000, 2000);
+
+    Areas areas = Areas();
+
+    THEN( "the rows that are filtered out are not decoded" ) {
+
+      REQUIRE_NOTHROW( areas.populate(json.data(), json.data() + json.size(), BethYw::WelshStatsJSON, cols,
+                                      &areasFilter, &measuresFilter, &yearsFilter) );
+
+      REQUIRE( areas.size() == 1 );
+      REQUIRE( areas.getArea("W06000001").getName("eng") == "Isle of Anglesey" );
+      REQUIRE( areas.getArea("W06000001").getMeasure("pop").size() == 1 );
+      REQUIRE( areas.getArea("W06000001").getMeasure("pop").getValue(2000) == 12.5 );
+
+    } // THEN
+
+    THEN( "each row is counted by the first filter that is checked and fails" ) {
+
+      Stats::reset();
+      Stats::enable();
+      areas.populate(json.data(), json.data() + json.size(), BethYw::WelshStatsJSON, cols,
+                     &areasFilter, &measuresFilter, &yearsFilter);
+      Stats::enable(false);
+
+      // The year of the first row is read first, and the area of the last row
+      // is read before its year
+      REQUIRE( Stats::totals()[Stats::ROWS_READ] == 3 );
+      REQUIRE( Stats::totals()[Stats::ROWS_FILTERED_YEAR] == 1 );
+      REQUIRE( Stats::totals()[Stats::ROWS_FILTERED_AREA] == 1 );
+      REQUIRE( Stats::totals()[Stats::ROWS_FILTERED_MEASURE] == 0 );
+
+      Stats::reset();
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "no filters" ) {
+
+    Areas areas = Areas();
+
+    THEN( "a value that cannot be decoded is an error" ) {
+
+      REQUIRE_THROWS_AS( areas.populate(json.data(), json.data() + json.size(), BethYw::WelshStatsJSON, cols,
+                                        nullptr, nullptr, nullptr),
+                         std::invalid_argument );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "filters that every row fails" ) {
+
+    const StringFilterSet measuresFilter = {"dens"};
+    const YearFilterTuple yearsFilter = std::make_tuple(2001, 2001);
+
+    Areas areas = Areas();
+
+    THEN( "no row is decoded or imported" ) {
+
+      REQUIRE_NOTHROW( areas.populate(json.data(), json.data() + json.size(), BethYw::WelshStatsJSON, cols,
+                                      nullptr, &measuresFilter, &yearsFilter) );
+
+      REQUIRE( areas.size() == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
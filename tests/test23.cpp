@@ -0,0 +1,160 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+#include <tuple>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../input.h"
+#include "../server.h"
+
+SCENARIO( "a query string can be parsed into filters", "[Server][args]" ) {
+
+  GIVEN( "an empty query string" ) {
+
+    auto query = BethYw::parseQuery("");
+
+    THEN( "everything is selected, as tables" ) {
+
+      REQUIRE( query.areasFilter.empty() );
+      REQUIRE( query.measuresFilter.empty() );
+      REQUIRE( query.yearsFilter == std::make_tuple(0u, 0u) );
+      REQUIRE_FALSE( query.json );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "each parameter, some percent-encoded" ) {
+
+    auto query = BethYw::parseQuery("areas=W06000011%2CW06000015&m=POP&years=2000-2010&json");
+
+    THEN( "the filters are parsed as the command line arguments are" ) {
+
+      REQUIRE( query.areasFilter == StringFilterSet({"W06000011", "W06000015"}) );
+      REQUIRE( query.measuresFilter == StringFilterSet({"pop"}) );
+      REQUIRE( query.yearsFilter == std::make_tuple(2000u, 2010u) );
+      REQUIRE( query.json );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an invalid years argument" ) {
+
+    THEN( "the command line's error is thrown" ) {
+
+      REQUIRE_THROWS_AS( BethYw::parseQuery("y=20x"), std::invalid_argument );
+      REQUIRE_THROWS_WITH( BethYw::parseQuery("y=20x"), "Invalid input for years argument" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an unknown parameter" ) {
+
+    THEN( "an invalid argument exception is thrown" ) {
+
+      REQUIRE_THROWS_WITH( BethYw::parseQuery("a=swansea&datasets=popden"), "Unknown query parameter: datasets" );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a query is answered from the data in memory", "[Server][Areas][select]" ) {
+
+  InputMappedFile input("datasets/popu1009.json");
+  input.open();
+
+  Areas areas = Areas();
+  areas.populate(input.begin(),
+                 input.end(),
+                 BethYw::WelshStatsJSON,
+                 BethYw::InputFiles::POPDEN.COLS,
+                 nullptr,
+                 nullptr,
+                 nullptr);
+
+  GIVEN( "a selection of two areas, one measure and a range of years" ) {
+
+    const StringFilterSet areasFilter = {"W06000011", "powys"};
+    const StringFilterSet measuresFilter = {"pop"};
+    const YearFilterTuple yearsFilter = std::make_tuple(2000, 2009);
+
+    Areas selection = areas.select(&areasFilter, &measuresFilter, &yearsFilter);
+
+    THEN( "only the selected data is copied" ) {
+
+      REQUIRE( selection.size() == 2 );
+      REQUIRE( selection.getArea("W06000023").getName("eng") == "Powys" );
+      REQUIRE( selection.getArea("W06000011").getAllMeasureCodenames().size() == 1 );
+      REQUIRE( selection.getArea("W06000011").getMeasure("pop").size() == 10 );
+      REQUIRE( selection.getArea("W06000011").getMeasure("pop").getValue(2005)
+               == areas.getArea("W06000011").getMeasure("pop").getValue(2005) );
+
+    } // THEN
+
+    THEN( "the selection is the same as importing with the filters" ) {
+
+      Areas filtered = Areas();
+      filtered.populate(input.begin(),
+                        input.end(),
+                        BethYw::WelshStatsJSON,
+                        BethYw::InputFiles::POPDEN.COLS,
+                        &areasFilter,
+                        &measuresFilter,
+                        &yearsFilter);
+
+      REQUIRE( selection.toJSON() == filtered.toJSON() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a GET request for / with a query" ) {
+
+    auto response = BethYw::respond(areas, "GET /?a=W06000011&m=pop&y=2000-2009&j HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+    const StringFilterSet areasFilter = {"W06000011"};
+    const StringFilterSet measuresFilter = {"pop"};
+    const YearFilterTuple yearsFilter = std::make_tuple(2000, 2009);
+    const std::string body = areas.select(&areasFilter, &measuresFilter, &yearsFilter).toJSON() + "\n";
+
+    THEN( "the response is the selected data, as the command line would print it" ) {
+
+      REQUIRE( response.compare(0, 17, "HTTP/1.0 200 OK\r\n") == 0 );
+      REQUIRE( response.find("Content-Type: application/json\r\n") != std::string::npos );
+      REQUIRE( response.find("Content-Length: " + std::to_string(body.size()) + "\r\n") != std::string::npos );
+      REQUIRE( response.substr(response.find("\r\n\r\n") + 4) == body );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "requests that cannot be answered" ) {
+
+    THEN( "an error status is returned" ) {
+
+      REQUIRE( BethYw::respond(areas, "GET /?y=20x HTTP/1.0\r\n\r\n").compare(0, 24, "HTTP/1.0 400 Bad Request") == 0 );
+      REQUIRE( BethYw::respond(areas, "nonsense\r\n\r\n").compare(0, 24, "HTTP/1.0 400 Bad Request") == 0 );
+      REQUIRE( BethYw::respond(areas, "POST / HTTP/1.0\r\n\r\n").compare(0, 12, "HTTP/1.0 405") == 0 );
+      REQUIRE( BethYw::respond(areas, "GET /data HTTP/1.0\r\n\r\n").compare(0, 12, "HTTP/1.0 404") == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,200 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../input.h"
+#include "../view.h"
+
+SCENARIO( "a MeasureView can be constructed from a Measure and a range of years", "[MeasureView]" ) {
+
+  Measure measure("Pop", "Population");
+  measure.setValue(1999, 10);
+  measure.setValue(2000, 20);
+  measure.setValue(2001, 25);
+  measure.setValue(2002, 40);
+
+  GIVEN( "a view of all the readings" ) {
+
+    MeasureView view(measure);
+
+    THEN( "it has the Measure's readings and statistics" ) {
+
+      REQUIRE( &view.getMeasure() == &measure );
+      REQUIRE( view.getCodename() == "pop" );
+      REQUIRE( view.getLabel() == "Population" );
+      REQUIRE( view.size() == measure.size() );
+      REQUIRE( view.getAverage() == measure.getAverage() );
+      REQUIRE( view.getDifference() == measure.getDifference() );
+      REQUIRE( view.getDifferenceAsPercentage() == measure.getDifferenceAsPercentage() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a view of the years 2000 to 2001" ) {
+
+    MeasureView view(measure, 2000, 2001);
+
+    THEN( "it has only the readings in the range, without copying them" ) {
+
+      REQUIRE( view.size() == 2 );
+      REQUIRE( (*view.begin()).year == 2000 );
+      REQUIRE( (*view.begin()).value == 20 );
+      REQUIRE( view.getAverage() == 22.5 );
+      REQUIRE( view.getDifference() == 5 );
+      REQUIRE( view.getDifferenceAsPercentage() == 25 );
+
+      REQUIRE( measure.size() == 4 );
+
+    } // THEN
+
+    THEN( "its table is that of a Measure with only those readings" ) {
+
+      Measure copy("Pop", "Population");
+      copy.setValue(2000, 20);
+      copy.setValue(2001, 25);
+
+      std::string viewTable, copyTable;
+      appendTable(viewTable, view);
+      appendTable(copyTable, copy);
+
+      REQUIRE( viewTable == copyTable );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a range of years with no readings, or the wrong way round" ) {
+
+    THEN( "the view is empty" ) {
+
+      REQUIRE( MeasureView(measure, 2010, 2020).size() == 0 );
+      REQUIRE( MeasureView(measure, 1990, 1998).size() == 0 );
+      REQUIRE( MeasureView(measure, 2001, 2000).size() == 0 );
+      REQUIRE( MeasureView(measure, 2010, 2020).getAverage() == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "an Areas object can be queried without copying its data", "[AreasView][Areas][query]" ) {
+
+  InputMappedFile input("datasets/popu1009.json");
+  input.open();
+
+  Areas areas = Areas();
+  areas.populate(input.begin(),
+                 input.end(),
+                 BethYw::WelshStatsJSON,
+                 BethYw::InputFiles::POPDEN.COLS,
+                 nullptr,
+                 nullptr,
+                 nullptr);
+
+  GIVEN( "a query of two areas, one measure and a range of years" ) {
+
+    const StringFilterSet areasFilter = {"W06000011", "powys"};
+    const StringFilterSet measuresFilter = {"pop"};
+    const YearFilterTuple yearsFilter = std::make_tuple(2000, 2009);
+
+    AreasView view = areas.query(&areasFilter, &measuresFilter, &yearsFilter);
+
+    THEN( "the view refers to the selected Area and Measure objects, in order" ) {
+
+      REQUIRE( view.size() == 2 );
+      REQUIRE( &view.getAreas()[0].second.getArea() == &areas.getArea("W06000011") );
+      REQUIRE( &view.getAreas()[1].second.getArea() == &areas.getArea("W06000023") );
+
+      const AreaView &swansea = view.getAreas()[0].second;
+      REQUIRE( swansea.size() == 1 );
+      REQUIRE( &swansea.getMeasures()[0].second.getMeasure() == &areas.getArea("W06000011").getMeasure("pop") );
+      REQUIRE( swansea.getMeasures()[0].second.size() == 10 );
+
+    } // THEN
+
+    THEN( "the output is the same as that of a copy of the selected data" ) {
+
+      Areas selection = areas.select(&areasFilter, &measuresFilter, &yearsFilter);
+
+      REQUIRE( view.toJSON() == selection.toJSON() );
+
+      std::stringstream viewTables, selectionTables;
+      viewTables << view;
+      selectionTables << selection;
+
+      REQUIRE( viewTables.str() == selectionTables.str() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a range of years that some measures have no readings in" ) {
+
+    const YearFilterTuple yearsFilter = std::make_tuple(1991, 1991);
+
+    AreasView view = areas.query(nullptr, nullptr, &yearsFilter);
+
+    THEN( "those measures are left out" ) {
+
+      for (auto &area : view.getAreas()) {
+        for (auto &measure : area.second.getMeasures()) {
+          REQUIRE( measure.second.size() == 1 );
+        }
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a query with no filters" ) {
+
+    AreasView view = areas.query(nullptr, nullptr, nullptr);
+
+    THEN( "the output is the same as that of the Areas object" ) {
+
+      REQUIRE( view.size() == areas.size() );
+      REQUIRE( view.toJSON() == areas.toJSON() );
+
+      std::stringstream viewTables, areasTables;
+      viewTables << view;
+      areasTables << areas;
+
+      REQUIRE( viewTables.str() == areasTables.str() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a query that matches no areas" ) {
+
+    const StringFilterSet areasFilter = {"nowhere"};
+
+    AreasView view = areas.query(&areasFilter, nullptr, nullptr);
+
+    THEN( "the view is empty" ) {
+
+      REQUIRE( view.size() == 0 );
+      REQUIRE( view.toJSON() == "{}" );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
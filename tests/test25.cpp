@@ -0,0 +1,152 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../input.h"
+
+SCENARIO( "the measures of every area can be found by codename and by year", "[Areas][index]" ) {
+
+  InputMappedFile input("datasets/popu1009.json");
+  input.open();
+
+  Areas areas = Areas();
+  areas.populate(input.begin(),
+                 input.end(),
+                 BethYw::WelshStatsJSON,
+                 BethYw::InputFiles::POPDEN.COLS,
+                 nullptr,
+                 nullptr,
+                 nullptr);
+
+  // The same as the indexes, found by walking every area
+  std::vector<std::string> popCodes;
+  size_t measuresIn2000 = 0;
+  for (auto &code : areas.getAllAuthorityCodes()) {
+    Area &area = areas.getArea(code);
+    for (auto &codename : area.getAllMeasureCodenames()) {
+      const Measure &measure = area.getMeasure(codename);
+      if (codename == "pop") {
+        popCodes.push_back(code);
+      }
+      for (auto year : measure.getAllYears()) {
+        measuresIn2000 += year == 2000;
+      }
+    }
+  }
+
+  areas.buildIndexes();
+
+  GIVEN( "a codename in any case" ) {
+
+    const Areas::Index &index = areas.getMeasureIndex("POP");
+
+    THEN( "the Measure of each Area with one is found, in order of local authority code" ) {
+
+      REQUIRE( index.size() == popCodes.size() );
+
+      for (size_t i = 0; i < index.size(); i++) {
+        REQUIRE( SymbolTable::resolve(index[i].localAuthorityCode) == popCodes[i] );
+        REQUIRE( SymbolTable::resolve(index[i].codename) == "pop" );
+        REQUIRE( index[i].measure == &areas.getArea(popCodes[i]).getMeasure("pop") );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a year" ) {
+
+    const Areas::Index &index = areas.getYearIndex(2000);
+
+    THEN( "every Measure with a value for it is found" ) {
+
+      REQUIRE( index.size() == measuresIn2000 );
+
+      for (auto &entry : index) {
+        REQUIRE_NOTHROW( entry.measure->getValue(2000) );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a codename or a year that no Measure has" ) {
+
+    THEN( "nothing is found" ) {
+
+      REQUIRE( areas.getMeasureIndex("not a measure").empty() );
+      REQUIRE( areas.getYearIndex(1066).empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "indexes that have been built, and then a change to the areas" ) {
+
+    const size_t popAreas = areas.getMeasureIndex("pop").size();
+
+    THEN( "an Area added with setArea() is found once the indexes are built again" ) {
+
+      Area area("X00000001");
+      Measure measure("pop", "Population");
+      measure.setValue(1066, 2000);
+      area.setMeasure("pop", measure);
+      areas.setArea("X00000001", area);
+
+      REQUIRE_THROWS_AS( areas.getMeasureIndex("pop"), std::logic_error );
+      REQUIRE_THROWS_AS( areas.getYearIndex(1066), std::logic_error );
+
+      areas.buildIndexes();
+
+      REQUIRE( areas.getMeasureIndex("pop").size() == popAreas + 1 );
+      REQUIRE( areas.getYearIndex(1066).size() == 1 );
+      REQUIRE( areas.getYearIndex(1066)[0].measure->getValue(1066) == 2000 );
+
+    } // THEN
+
+    THEN( "a Measure set through getArea() is found once the indexes are built again" ) {
+
+      Measure measure("newmeasure", "A new measure");
+      measure.setValue(1066, 1);
+      areas.getArea("W06000011").setMeasure("newmeasure", measure);
+
+      REQUIRE_THROWS_AS( areas.getMeasureIndex("newmeasure"), std::logic_error );
+
+      areas.buildIndexes();
+
+      REQUIRE( areas.getMeasureIndex("newmeasure").size() == 1 );
+      REQUIRE( SymbolTable::resolve(areas.getMeasureIndex("newmeasure")[0].localAuthorityCode) == "W06000011" );
+      REQUIRE( areas.getYearIndex(1066).size() == 1 );
+
+    } // THEN
+
+    THEN( "the indexes of an Areas object merged into another are emptied" ) {
+
+      Areas merged = Areas();
+      merged.merge(std::move(areas));
+      merged.buildIndexes();
+      areas.buildIndexes();
+
+      REQUIRE( merged.getMeasureIndex("pop").size() == popAreas );
+      REQUIRE( areas.getMeasureIndex("pop").empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
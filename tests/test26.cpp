@@ -0,0 +1,195 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <iterator>
+#include <string>
+#include <type_traits>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../input.h"
+
+SCENARIO( "Measure objects are equal only if their codenames, labels and readings are", "[Measure][equality]" ) {
+
+  Measure measure("Pop", "Population");
+  measure.setValue(1999, 10);
+  measure.setValue(2000, 20);
+
+  GIVEN( "a Measure with the same readings, set in another order and with a codename in another case" ) {
+
+    Measure other("POP", "Population");
+    other.setValue(2000, 20);
+    other.setValue(1999, 10);
+
+    THEN( "they are equal" ) {
+
+      REQUIRE( measure == other );
+      REQUIRE( other == measure );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "Measure objects that differ in one way each" ) {
+
+    Measure value("pop", "Population");
+    value.setValue(1999, 10);
+    value.setValue(2000, 21);
+
+    Measure year("pop", "Population");
+    year.setValue(1999, 10);
+    year.setValue(2001, 20);
+
+    Measure extra(measure);
+    extra.setValue(2001, 30);
+
+    Measure label("pop", "People");
+    label.setValue(1999, 10);
+    label.setValue(2000, 20);
+
+    THEN( "none of them are equal to the Measure, either way round" ) {
+
+      REQUIRE_FALSE( measure == value );
+      REQUIRE_FALSE( measure == year );
+      REQUIRE_FALSE( measure == extra );
+      REQUIRE_FALSE( extra == measure );
+      REQUIRE_FALSE( measure == label );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "Area objects are equal only if their codes, names and measures are", "[Area][equality]" ) {
+
+  Measure measure("pop", "Population");
+  measure.setValue(2000, 20);
+
+  Area area("W06000011");
+  area.setName("eng", "Swansea");
+  area.setName("cym", "Abertawe");
+  area.setMeasure("pop", measure);
+
+  GIVEN( "an Area with the same data, set in another order" ) {
+
+    Area other("W06000011");
+    other.setMeasure("POP", measure);
+    other.setName("CYM", "Abertawe");
+    other.setName("eng", "Swansea");
+
+    THEN( "they are equal" ) {
+
+      REQUIRE( area == other );
+      REQUIRE( other == area );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "Area objects that differ in one way each" ) {
+
+    Area code("W06000015");
+    code.setName("eng", "Swansea");
+    code.setName("cym", "Abertawe");
+    code.setMeasure("pop", measure);
+
+    Area name(area);
+    name.setName("cym", "Swansea");
+
+    Area extraName(area);
+    extraName.setName("fra", "Swansea");
+
+    Measure changed(measure);
+    changed.setValue(2000, 21);
+    Area value(area);
+    value.setMeasure("pop", changed);
+
+    Measure dens("dens", "Population density");
+    dens.setValue(2000, 1);
+    Area extraMeasure(area);
+    extraMeasure.setMeasure("dens", dens);
+
+    THEN( "none of them are equal to the Area, either way round" ) {
+
+      REQUIRE_FALSE( area == code );
+      REQUIRE_FALSE( area == name );
+      REQUIRE_FALSE( area == extraName );
+      REQUIRE_FALSE( extraName == area );
+      REQUIRE_FALSE( area == value );
+      REQUIRE_FALSE( area == extraMeasure );
+      REQUIRE_FALSE( extraMeasure == area );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "every Area of an imported dataset and of a copy of it" ) {
+
+    InputMappedFile input("datasets/popu1009.json");
+    input.open();
+
+    Areas areas = Areas();
+    areas.populate(input.begin(),
+                   input.end(),
+                   BethYw::WelshStatsJSON,
+                   BethYw::InputFiles::POPDEN.COLS,
+                   nullptr,
+                   nullptr,
+                   nullptr);
+
+    Areas copy(areas);
+
+    THEN( "each is equal to its copy, and not to any other" ) {
+
+      auto codes = areas.getAllAuthorityCodes();
+      for (size_t i = 0; i < codes.size(); i++) {
+        REQUIRE( areas.getArea(codes[i]) == copy.getArea(codes[i]) );
+        REQUIRE_FALSE( areas.getArea(codes[i]) == copy.getArea(codes[(i + 1) % codes.size()]) );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "the readings of a Measure can be iterated over in chronological order", "[Measure][iterator]" ) {
+
+  Measure measure("pop", "Population");
+  measure.setValue(2001, 20);
+  measure.setValue(1999, 10);
+
+  GIVEN( "an iterator to the first reading" ) {
+
+    auto it = measure.begin();
+
+    THEN( "it is an input iterator whose readings can be reached with * or ->" ) {
+
+      REQUIRE( (std::is_same<std::iterator_traits<Measure::const_iterator>::iterator_category,
+                             std::input_iterator_tag>::value) );
+
+      REQUIRE( (*it).year == 1999 );
+      REQUIRE( it->value == 10 );
+      ++it;
+      REQUIRE( it->year == 2001 );
+      REQUIRE( (*it).value == 20 );
+      it++;
+      REQUIRE( it == measure.end() );
+      REQUIRE( std::distance(measure.begin(), measure.end()) == 2 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,114 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../input.h"
+
+SCENARIO( "an AuthorityByYearCSV dataset can be imported with a range of years", "[Areas][AuthorityByYearCSV]" ) {
+
+  Areas areas = Areas();
+
+  InputFile areasFile("datasets/areas.csv");
+  areas.populateFromAuthorityCodeCSV(areasFile.open(), BethYw::InputFiles::AREAS.COLS);
+
+  GIVEN( "complete-popu1009-pop.csv and the years 2000 to 2012" ) {
+
+    const YearFilterTuple yearsFilter = std::make_tuple(2000, 2012);
+
+    InputFile popFile("datasets/complete-popu1009-pop.csv");
+    areas.populateFromAuthorityByYearCSV(popFile.open(),
+                                         BethYw::InputFiles::COMPLETE_POP.COLS,
+                                         nullptr,
+                                         nullptr,
+                                         &yearsFilter);
+
+    THEN( "only the values in the range are imported, each for its own year" ) {
+
+      // AuthorityCode,1991,2001,2011,2012,...
+      // W06000001,69123,67806,69913,70037,...
+      const Measure &pop = areas.getArea("W06000001").getMeasure("pop");
+
+      REQUIRE( pop.size() == 3 );
+      REQUIRE_THROWS_AS( pop.getValue(1991), std::out_of_range );
+      REQUIRE( pop.getValue(2001) == 67806 );
+      REQUIRE( pop.getValue(2011) == 69913 );
+      REQUIRE( pop.getValue(2012) == 70037 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a row with an empty value and a row with missing values" ) {
+
+    std::istringstream is("AuthorityCode,2001,2002,2003\n"
+                          "W06000001,10,,30\n"
+                          "W06000002,40\n");
+
+    areas.populateFromAuthorityByYearCSV(is, BethYw::InputFiles::COMPLETE_POP.COLS, nullptr, nullptr, nullptr);
+
+    THEN( "only the values that are there are imported" ) {
+
+      const Measure &first = areas.getArea("W06000001").getMeasure("pop");
+      REQUIRE( first.size() == 2 );
+      REQUIRE( first.getValue(2001) == 10 );
+      REQUIRE_THROWS_AS( first.getValue(2002), std::out_of_range );
+      REQUIRE( first.getValue(2003) == 30 );
+
+      const Measure &second = areas.getArea("W06000002").getMeasure("pop");
+      REQUIRE( second.size() == 1 );
+      REQUIRE( second.getValue(2001) == 40 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "headings that are not an authority code followed by years" ) {
+
+    THEN( "a malformed file error is thrown" ) {
+
+      std::istringstream wrongCode("Code,2001,2002\nW06000001,10,20\n");
+      REQUIRE_THROWS_WITH( areas.populateFromAuthorityByYearCSV(wrongCode, BethYw::InputFiles::COMPLETE_POP.COLS, nullptr, nullptr, nullptr),
+                           "Malformed file: headings are not correct" );
+
+      std::istringstream notAYear("AuthorityCode,2001,total\nW06000001,10,20\n");
+      REQUIRE_THROWS_WITH( areas.populateFromAuthorityByYearCSV(notAYear, BethYw::InputFiles::COMPLETE_POP.COLS, nullptr, nullptr, nullptr),
+                           "Malformed file: headings are not correct" );
+
+      std::istringstream noYears("AuthorityCode\nW06000001\n");
+      REQUIRE_THROWS_AS( areas.populateFromAuthorityByYearCSV(noYears, BethYw::InputFiles::COMPLETE_POP.COLS, nullptr, nullptr, nullptr),
+                         std::runtime_error );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a value that is not a number" ) {
+
+    std::istringstream is("AuthorityCode,2001\nW06000001,ten\n");
+
+    THEN( "a malformed file error is thrown" ) {
+
+      REQUIRE_THROWS_WITH( areas.populateFromAuthorityByYearCSV(is, BethYw::InputFiles::COMPLETE_POP.COLS, nullptr, nullptr, nullptr),
+                           "Malformed file: invalid value for W06000001 in 2001" );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
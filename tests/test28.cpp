@@ -0,0 +1,226 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+
+// Import areas.csv and then the datasets with the given number of threads,
+// returning whether every dataset was imported and what was printed to the
+// standard error
+static bool importDatasets(Areas &areas,
+                           const std::string &dir,
+                           const std::vector<BethYw::InputFileSource> &datasets,
+                           unsigned int threads,
+                           std::string &errors) {
+  std::ostringstream cerr;
+  auto previous = std::cerr.rdbuf(cerr.rdbuf());
+
+  BethYw::loadAreas(areas, dir, nullptr);
+  bool imported = BethYw::loadDatasets(areas, dir, datasets, nullptr, nullptr, nullptr, threads);
+
+  std::cerr.rdbuf(previous);
+  errors = cerr.str();
+  return imported;
+}
+
+// Check that two Areas objects have equal areas, and the same output
+static void requireSameAreas(const Areas &serial, const Areas &threaded) {
+  REQUIRE( threaded.getAllAuthorityCodes() == serial.getAllAuthorityCodes() );
+
+  for (auto &code : serial.getAllAuthorityCodes()) {
+    REQUIRE( threaded.getArea(code) == serial.getArea(code) );
+  }
+
+  REQUIRE( threaded.toJSON() == serial.toJSON() );
+}
+
+SCENARIO( "datasets imported concurrently give the same result as importing them one after another", "[threads]" ) {
+
+  GIVEN( "all the datasets" ) {
+
+    const std::string dir = std::string("datasets") + DIR_SEP;
+    const std::vector<BethYw::InputFileSource> datasets(BethYw::InputFiles::DATASETS,
+                                                        BethYw::InputFiles::DATASETS + BethYw::InputFiles::NUM_DATASETS);
+
+    Areas serial = Areas();
+    Areas threaded = Areas();
+    std::string serialErrors, threadedErrors;
+
+    const bool serialImported = importDatasets(serial, dir, datasets, 1, serialErrors);
+    const bool threadedImported = importDatasets(threaded, dir, datasets, 4, threadedErrors);
+
+    THEN( "the areas and their output are the same" ) {
+
+      REQUIRE( serialImported );
+      REQUIRE( threadedImported );
+      REQUIRE( threadedErrors == serialErrors );
+
+      requireSameAreas(serial, threaded);
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a dataset that only imports after an earlier one, and a malformed dataset" ) {
+
+#ifdef _WIN32
+    _mkdir("test28-datasets");
+#else
+    mkdir("test28-datasets", 0777);
+#endif
+    const std::string dir = std::string("test28-datasets") + DIR_SEP;
+
+    // areas.csv has only the first area, so the areas the AuthorityByYearCSV
+    // dataset refers to are only created by the JSON dataset before it. Its
+    // worker (starting from just the areas in areas.csv) fails, and so it is
+    // imported again once the JSON dataset has been merged
+    {
+      std::ifstream areasIn("datasets/areas.csv");
+      std::ofstream areasOut(dir + "areas.csv");
+      std::string line;
+      std::getline(areasIn, line);
+      areasOut << line << "\n";
+      std::getline(areasIn, line);
+      areasOut << line << "\n";
+
+      std::ifstream jsonIn("datasets/popu1009.json", std::ios::binary);
+      std::ofstream jsonOut(dir + "popu1009.json", std::ios::binary);
+      jsonOut << jsonIn.rdbuf();
+
+      // The headings and the rows of the first 11 areas, which are all in
+      // popu1009.json
+      std::ifstream popIn("datasets/complete-popu1009-pop.csv");
+      std::ofstream popOut(dir + "complete-popu1009-pop.csv");
+      for (int i = 0; i <= 11 && std::getline(popIn, line); i++) {
+        popOut << line << "\n";
+      }
+
+      std::ofstream areaOut(dir + "complete-popu1009-area.csv");
+      areaOut << "Code,2001\nW06000001,10\n";
+    }
+
+    const std::vector<BethYw::InputFileSource> datasets = {BethYw::InputFiles::POPDEN,
+                                                           BethYw::InputFiles::COMPLETE_POP,
+                                                           BethYw::InputFiles::COMPLETE_AREA};
+
+    Areas serial = Areas();
+    Areas threaded = Areas();
+    std::string serialErrors, threadedErrors;
+
+    const bool serialImported = importDatasets(serial, dir, datasets, 1, serialErrors);
+    const bool threadedImported = importDatasets(threaded, dir, datasets, 4, threadedErrors);
+
+    std::remove((dir + "areas.csv").c_str());
+    std::remove((dir + "popu1009.json").c_str());
+    std::remove((dir + "complete-popu1009-pop.csv").c_str());
+    std::remove((dir + "complete-popu1009-area.csv").c_str());
+    std::remove("test28-datasets");
+
+    THEN( "the same error is reported for the malformed dataset" ) {
+
+      REQUIRE_FALSE( serialImported );
+      REQUIRE_FALSE( threadedImported );
+      REQUIRE( serialErrors.find("Malformed file: headings are not correct") != std::string::npos );
+      REQUIRE( threadedErrors == serialErrors );
+
+    } // THEN
+
+    THEN( "the dataset that failed in its worker is imported, and the result is the same" ) {
+
+      REQUIRE( serial.size() > 1 );
+      REQUIRE_NOTHROW( threaded.getArea("W06000011").getMeasure("pop") );
+
+      requireSameAreas(serial, threaded);
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a dataset that names an area differently to areas.csv, before an AuthorityByYearCSV dataset" ) {
+
+#ifdef _WIN32
+    _mkdir("test28-names");
+#else
+    mkdir("test28-names", 0777);
+#endif
+    const std::string dir = std::string("test28-names") + DIR_SEP;
+
+    // The JSON dataset renames W06000001, and the AuthorityByYearCSV dataset
+    // after it has no names, so the name from the JSON dataset is kept
+    {
+      std::ifstream areasIn("datasets/areas.csv", std::ios::binary);
+      std::ofstream areasOut(dir + "areas.csv", std::ios::binary);
+      areasOut << areasIn.rdbuf();
+
+      std::ifstream jsonIn("datasets/popu1009.json", std::ios::binary);
+      std::stringstream json;
+      json << jsonIn.rdbuf();
+
+      std::string renamed = json.str();
+      const std::string from = "\"Isle of Anglesey\"";
+      const std::string to = "\"Anglesey\"";
+      for (size_t pos = renamed.find(from); pos != std::string::npos; pos = renamed.find(from, pos)) {
+        renamed.replace(pos, from.size(), to);
+      }
+
+      std::ofstream jsonOut(dir + "popu1009.json", std::ios::binary);
+      jsonOut << renamed;
+
+      std::ifstream popIn("datasets/complete-popu1009-pop.csv", std::ios::binary);
+      std::ofstream popOut(dir + "complete-popu1009-pop.csv", std::ios::binary);
+      popOut << popIn.rdbuf();
+    }
+
+    const std::vector<BethYw::InputFileSource> datasets = {BethYw::InputFiles::POPDEN,
+                                                           BethYw::InputFiles::COMPLETE_POP};
+
+    Areas serial = Areas();
+    Areas threaded = Areas();
+    std::string serialErrors, threadedErrors;
+
+    const bool serialImported = importDatasets(serial, dir, datasets, 1, serialErrors);
+    const bool threadedImported = importDatasets(threaded, dir, datasets, 4, threadedErrors);
+
+    std::remove((dir + "areas.csv").c_str());
+    std::remove((dir + "popu1009.json").c_str());
+    std::remove((dir + "complete-popu1009-pop.csv").c_str());
+    std::remove("test28-names");
+
+    THEN( "the name from the dataset is kept, and the result is the same" ) {
+
+      REQUIRE( serialImported );
+      REQUIRE( threadedImported );
+      REQUIRE( serial.getArea("W06000001").getName("eng") == "Anglesey" );
+      REQUIRE( threaded.getArea("W06000001").getName("eng") == "Anglesey" );
+
+      requireSameAreas(serial, threaded);
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
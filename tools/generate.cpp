@@ -0,0 +1,163 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  bethyw-generate writes synthetic datasets of any size, with the same file
+  names and column headings as the bundled ones (see datasets.h), so that
+  bethyw can import them unchanged for scale testing, e.g.
+
+	./bin/bethyw-generate --dir /tmp/big --authorities 10000 --measures 8
+	./bin/bethyw --dir /tmp/big -j > /dev/null
+
+  areas.csv is always written, as the other datasets refer to its authorities.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+#include "../lib_cxxopts.hpp"
+
+#include "../bethyw.h"
+#include "../datasets.h"
+#include "../generator.h"
+
+// Create the output directory, if it does not exist
+static void makeDirectory(const std::string &dir)
+{
+#ifdef _WIN32
+	int result = _mkdir(dir.c_str());
+#else
+	int result = mkdir(dir.c_str(), 0777);
+#endif
+
+	if (result != 0 && errno != EEXIST)
+	{
+		throw std::runtime_error("Cannot create directory " + dir);
+	}
+}
+
+// Write one dataset to dir, and report its size
+static void writeDataset(DatasetGenerator &generator, const std::string &dir, const BethYw::InputFileSource &source)
+{
+	const std::string path = dir + DIR_SEP + source.FILE;
+	std::ofstream os(path, std::ios::binary);
+
+	if (!os)
+	{
+		throw std::runtime_error("Cannot open " + path + " for writing");
+	}
+
+	size_t rows = generator.write(os, source);
+	os.close();
+
+	if (!os)
+	{
+		throw std::runtime_error("Cannot write " + path);
+	}
+
+	std::cerr << "Wrote " << path << " (" << rows << " rows)" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	GeneratorOptions defaults;
+
+	cxxopts::Options cxxopts(
+		"bethyw-generate",
+		"Writes synthetic datasets, with the same file names and columns as the "
+		"bundled datasets, for scale testing Beth Yw?\n");
+
+	cxxopts.add_options()(
+		"dir",
+		"Directory to write the datasets to (created if it does not exist)",
+		cxxopts::value<std::string>()->default_value("generated"))(
+
+		"d,datasets",
+		"The dataset(s) to write as a comma-separated list of codes "
+		"(omit or set to 'all' to write all datasets)",
+		cxxopts::value<std::vector<std::string>>())(
+
+		"authorities",
+		"Number of local authorities",
+		cxxopts::value<unsigned int>()->default_value(std::to_string(defaults.authorities)))(
+
+		"measures",
+		"Number of measures in each dataset that has more than one",
+		cxxopts::value<unsigned int>()->default_value(std::to_string(defaults.measures)))(
+
+		"first-year",
+		"The first year of readings",
+		cxxopts::value<unsigned int>()->default_value(std::to_string(defaults.firstYear)))(
+
+		"years",
+		"Number of years of readings",
+		cxxopts::value<unsigned int>()->default_value(std::to_string(defaults.years)))(
+
+		"noise",
+		"Number of extra (not imported) columns in each row of the JSON datasets",
+		cxxopts::value<unsigned int>()->default_value(std::to_string(defaults.noiseColumns)))(
+
+		"seed",
+		"Seed for the pseudo-random values",
+		cxxopts::value<std::uint32_t>()->default_value(std::to_string(defaults.seed)))(
+
+		"h,help",
+		"Print usage.");
+
+	try
+	{
+		auto args = cxxopts.parse(argc, argv);
+
+		if (args.count("help"))
+		{
+			std::cerr << cxxopts.help() << std::endl;
+			return 0;
+		}
+
+		GeneratorOptions options;
+		options.authorities = args["authorities"].as<unsigned int>();
+		options.measures = args["measures"].as<unsigned int>();
+		options.firstYear = args["first-year"].as<unsigned int>();
+		options.years = args["years"].as<unsigned int>();
+		options.noiseColumns = args["noise"].as<unsigned int>();
+		options.seed = args["seed"].as<std::uint32_t>();
+
+		if (options.authorities == 0 || options.measures == 0 || options.years == 0)
+		{
+			throw std::invalid_argument("There must be at least one authority, measure and year");
+		}
+
+		auto datasets = BethYw::parseDatasetsArg(args);
+		const std::string dir = args["dir"].as<std::string>();
+
+		makeDirectory(dir);
+
+		DatasetGenerator generator(options);
+		writeDataset(generator, dir, BethYw::InputFiles::AREAS);
+		for (auto &source : datasets)
+		{
+			writeDataset(generator, dir, source);
+		}
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
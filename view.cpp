@@ -0,0 +1,843 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the implementation of the views of imported data. See
+  the header file for additional comments.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <tuple>
+
+#include "lib_json.hpp"
+
+#include "view.h"
+#include "filter.h"
+
+/*
+  Constructor for a view of all the readings of a Measure.
+
+  @param measure
+	The Measure to view
+
+  @example
+	std::string table;
+	appendTable(table, MeasureView(measure));
+*/
+MeasureView::MeasureView(const Measure &measure) noexcept
+	: measure(&measure), first(measure.begin()), last(measure.end()) {}
+
+/*
+  Constructor for a view of the readings of a Measure from one year to
+  another, inclusive.
+
+  @param measure
+	The Measure to view
+
+  @param firstYear
+	The first year of the readings to view
+
+  @param lastYear
+	The last year of the readings to view
+
+  @example
+	MeasureView view(measure, 2000, 2010);
+	auto average = view.getAverage(); // of the readings from 2000 to 2010
+*/
+MeasureView::MeasureView(const Measure &measure, unsigned int firstYear, unsigned int lastYear) noexcept
+	: measure(&measure),
+	  first(measure.lowerBound(firstYear)),
+	  last(firstYear <= lastYear ? measure.upperBound(lastYear) : first) {}
+
+// Auxiliary method to get the Measure being viewed
+const Measure &MeasureView::getMeasure() const noexcept
+{
+	return *this->measure;
+}
+
+// Auxiliary method to get the codename of the Measure being viewed
+const std::string &MeasureView::getCodename() const noexcept
+{
+	return this->measure->getCodename();
+}
+
+// Auxiliary method to get the label of the Measure being viewed
+const std::string &MeasureView::getLabel() const noexcept
+{
+	return this->measure->getLabel();
+}
+
+/*
+  Get the number of readings in the view.
+
+  @return
+	The number of readings
+*/
+const int MeasureView::size() const noexcept
+{
+	return static_cast<int>(this->last - this->first);
+}
+
+/*
+  As Measure::getDifference(), but for the readings in the view.
+
+  @return
+	The difference/change in value from the first to the last year in the
+	view, or 0 if it cannot be calculated
+*/
+const double MeasureView::getDifference() const noexcept
+{
+	if (this->size() == 0)
+	{
+		return 0;
+	}
+
+	double first_year = (*this->first).value;
+	double last_year = (*(this->first + (this->size() - 1))).value;
+
+	return std::abs(last_year - first_year);
+}
+
+/*
+  As Measure::getDifferenceAsPercentage(), but for the readings in the view.
+
+  @return
+	The difference/change in value from the first to the last year in the
+	view as a percentage, or 0 if it cannot be calculated
+*/
+const double MeasureView::getDifferenceAsPercentage() const noexcept
+{
+	if (this->size() == 0)
+	{
+		return 0;
+	}
+
+	double first_year = (*this->first).value;
+	double last_year = (*(this->first + (this->size() - 1))).value;
+
+	// Cannot divide by zero
+	if (first_year == 0)
+	{
+		return 0;
+	}
+
+	return (std::abs(last_year - first_year) / first_year) * 100;
+}
+
+/*
+  As Measure::getAverage(), but for the readings in the view.
+
+  @return
+	The average value for the years in the view, or 0 if it cannot be
+	calculated
+*/
+const double MeasureView::getAverage() const noexcept
+{
+	double sum = 0;
+
+	if (this->size() == 0)
+	{
+		return 0;
+	}
+
+	for (auto reading : *this)
+	{
+		sum += reading.value;
+	}
+
+	return sum / this->size();
+}
+
+/*
+  Get an iterator to the first reading in the view.
+
+  @return
+	An iterator to the first reading
+
+  @example
+	for (auto reading : MeasureView(measure, 2000, 2010)) {
+	  std::cout << reading.year << ": " << reading.value << std::endl;
+	}
+*/
+Measure::const_iterator MeasureView::begin() const noexcept
+{
+	return this->first;
+}
+
+/*
+  Get an iterator to one past the last reading in the view.
+
+  @return
+	An iterator to one past the last reading
+*/
+Measure::const_iterator MeasureView::end() const noexcept
+{
+	return this->last;
+}
+
+// Auxiliary function to append a number formatted as std::to_string() would,
+// returning the number of characters appended
+static size_t appendNumber(std::string &out, double value)
+{
+	char number[512];
+	int length = std::snprintf(number, sizeof(number), "%f", value);
+	out.append(number, length);
+
+	return length;
+}
+
+// Auxiliary function to append a column heading right-aligned to the width of
+// the value below it
+static void appendHeading(std::string &out, const char *heading, size_t headingLength, size_t width)
+{
+	if (width > headingLength)
+	{
+		out.append(width - headingLength, ' ');
+	}
+	out.append(heading, headingLength);
+}
+
+/*
+  Append the table that operator<< outputs for a Measure, with only the
+  readings in a view, to a string. Each value is formatted once, for both its
+  column width and the table.
+
+  @param out
+	The string to append the table to
+
+  @param measure
+	The MeasureView to output
+
+  @return
+	void
+
+  @example
+	std::string table;
+	appendTable(table, MeasureView(measure, 2000, 2010));
+	std::cout << table;
+*/
+void appendTable(std::string &out, const MeasureView &measure)
+{
+	out.append(measure.getLabel());
+	out.append(" (");
+	out.append(measure.getCodename());
+	out.append(")\n");
+
+	// If no data in measurement output "<no data>"
+	if (measure.size() == 0)
+	{
+		out.append("<no data>\n\n");
+		return;
+	}
+
+	// Format the row of values first, as the width of each value decides how
+	// much the heading above it is padded
+	std::string values;
+	std::vector<size_t> widths;
+	widths.reserve(measure.size());
+
+	for (auto reading : measure)
+	{
+		widths.push_back(appendNumber(values, reading.value));
+		values.push_back(' ');
+	}
+
+	size_t averageWidth = appendNumber(values, measure.getAverage());
+	values.push_back(' ');
+	size_t differenceWidth = appendNumber(values, measure.getDifference());
+	values.push_back(' ');
+	size_t percentageWidth = appendNumber(values, measure.getDifferenceAsPercentage());
+	values.append("\n\n");
+
+	size_t column = 0;
+	for (auto reading : measure)
+	{
+		char year[16];
+		int yearLength = std::snprintf(year, sizeof(year), "%u", reading.year);
+
+		appendHeading(out, year, yearLength, widths[column++]);
+		out.push_back(' ');
+	}
+
+	appendHeading(out, "Average", 7, averageWidth);
+	out.push_back(' ');
+	appendHeading(out, "Diff.", 5, differenceWidth);
+	out.push_back(' ');
+	appendHeading(out, "% Diff.", 7, percentageWidth);
+	out.push_back('\n');
+
+	out.append(values);
+}
+
+/*
+  Constructor for a view of an Area and those of its measures that are
+  selected, in order of their codenames.
+
+  @param area
+	The Area to view
+
+  @param measuresFilter
+	An unordered set of lowercase measure codenames to select, or empty (or
+	nullptr) to select all measures
+
+  @param yearsFilter
+	An two-pair tuple of unsigned ints corresponding to the range of years
+	to select, which should both be 0 (or nullptr) to select all years. As
+	when importing with a years filter, a measure with no readings in the
+	range is left out.
+
+  @example
+	auto measuresFilter = BethYw::parseMeasuresArg(args);
+	auto yearsFilter = BethYw::parseYearsArg(args);
+
+	AreaView view(area, &measuresFilter, &yearsFilter);
+*/
+AreaView::AreaView(const Area &area,
+				   const StringFilterSet *const measuresFilter,
+				   const YearFilterTuple *const yearsFilter)
+	: area(&area)
+{
+	const bool filterMeasures = measuresFilter != nullptr && !measuresFilter->empty();
+	const bool filterYears = yearsFilter != nullptr &&
+							 std::get<0>(*yearsFilter) != 0 &&
+							 std::get<1>(*yearsFilter) != 0;
+
+	this->measures.reserve(area.measures.size());
+
+	for (auto &entry : area.measures)
+	{
+		if (filterMeasures && measuresFilter->find(SymbolTable::resolve(entry.first)) == measuresFilter->end())
+		{
+			continue;
+		}
+
+		if (!filterYears)
+		{
+			this->measures.emplace_back(entry.first, MeasureView(entry.second));
+			continue;
+		}
+
+		MeasureView measure(entry.second, std::get<0>(*yearsFilter), std::get<1>(*yearsFilter));
+		if (measure.size() != 0)
+		{
+			this->measures.emplace_back(entry.first, measure);
+		}
+	}
+
+	// The measures are keyed on Symbols, which are not in alphabetical order
+	std::sort(this->measures.begin(), this->measures.end(),
+			  [](const value_type &a, const value_type &b) -> bool
+			  {
+				  return SymbolTable::resolve(a.first) < SymbolTable::resolve(b.first);
+			  });
+}
+
+// Auxiliary method to get the Area being viewed
+const Area &AreaView::getArea() const noexcept
+{
+	return *this->area;
+}
+
+// Auxiliary method to get the views of the selected measures, in order of
+// their codenames
+const std::vector<AreaView::value_type> &AreaView::getMeasures() const noexcept
+{
+	return this->measures;
+}
+
+/*
+  Get the number of measures selected in the view.
+
+  @return
+	The number of measures
+*/
+const int AreaView::size() const noexcept
+{
+	return static_cast<int>(this->measures.size());
+}
+
+/*
+  Append the output of operator<< for the Area of a view, with only the
+  selected measures and readings, to a string.
+
+  @param out
+	The string to append the tables to
+
+  @param view
+	The AreaView to output
+
+  @return
+	void
+
+  @example
+	std::string tables;
+	appendTable(tables, AreaView(area, &measuresFilter, &yearsFilter));
+	std::cout << tables;
+*/
+void appendTable(std::string &out, const AreaView &view)
+{
+	const Area &area = view.getArea();
+	auto areaNames = area.getAllNames();
+
+	// if no english or welsh name output "Unnamed"
+	if (areaNames.empty())
+	{
+		out.append("Unnamed");
+	}
+
+	// If english or/and welsh is set, output them
+	for (size_t i = 0; i < areaNames.size(); i++)
+	{
+		out.append(area.getName(areaNames[i]));
+
+		if (i < areaNames.size() - 1)
+		{
+			out.append(" / ");
+		}
+	}
+
+	out.append(" (");
+	out.append(area.getLocalAuthorityCode());
+	out.append(")\n");
+
+	// If no measurement code (i.e. no measures) output "<no measures>"
+	if (view.getMeasures().empty())
+	{
+		out.append("<no measures>\n\n");
+		return;
+	}
+
+	for (auto &entry : view.getMeasures())
+	{
+		appendTable(out, entry.second);
+	}
+}
+
+/*
+  Constructor for a view of the areas of an Areas object that are selected,
+  in order of their local authority codes, with only the measures and years
+  that are selected.
+
+  @param areas
+	The Areas object to view
+
+  @param areasFilter
+	An unordered set of strings to select areas by, each of which selects
+	the areas with it in their local authority code or one of their names
+	(ignoring case), or empty (or nullptr) to select all areas
+
+  @param measuresFilter
+	An unordered set of lowercase measure codenames to select, or empty (or
+	nullptr) to select all measures
+
+  @param yearsFilter
+	An two-pair tuple of unsigned ints corresponding to the range of years
+	to select, which should both be 0 (or nullptr) to select all years
+
+  @example
+	auto areasFilter = BethYw::parseAreasArg(args);
+	auto measuresFilter = BethYw::parseMeasuresArg(args);
+	auto yearsFilter = BethYw::parseYearsArg(args);
+
+	std::cout << AreasView(data, &areasFilter, &measuresFilter, &yearsFilter);
+*/
+AreasView::AreasView(const Areas &areas,
+					 const StringFilterSet *const areasFilter,
+					 const StringFilterSet *const measuresFilter,
+					 const YearFilterTuple *const yearsFilter)
+{
+	const AreaFilterMatcher areasMatcher(areasFilter);
+
+	// Only the areas that match are sorted, so a narrow query does not pay for
+	// sorting all of them
+	std::vector<const AreasContainer::value_type *> matched;
+
+	for (auto &entry : areas.container)
+	{
+		const Area &area = entry.second;
+		bool matches = areasMatcher.matchesAll() || areasMatcher.matches(area.getLocalAuthorityCode());
+
+		for (auto name = area.names.begin(); !matches && name != area.names.end(); ++name)
+		{
+			matches = areasMatcher.matches(SymbolTable::resolve(name->second));
+		}
+
+		if (matches)
+		{
+			matched.push_back(&entry);
+		}
+	}
+
+	std::sort(matched.begin(), matched.end(),
+			  [](const AreasContainer::value_type *a, const AreasContainer::value_type *b) -> bool
+			  {
+				  return SymbolTable::resolve(a->first) < SymbolTable::resolve(b->first);
+			  });
+
+	this->areas.reserve(matched.size());
+	for (auto entry : matched)
+	{
+		this->areas.emplace_back(entry->first, AreaView(entry->second, measuresFilter, yearsFilter));
+	}
+}
+
+// Auxiliary method to get the views of the selected areas, in order of their
+// local authority codes
+const std::vector<AreasView::value_type> &AreasView::getAreas() const noexcept
+{
+	return this->areas;
+}
+
+/*
+  Get the number of areas selected in the view.
+
+  @return
+	The number of areas
+*/
+const int AreasView::size() const noexcept
+{
+	return static_cast<int>(this->areas.size());
+}
+
+/*
+  Convert the view to JSON, in the same format as Areas::toJSON().
+
+  @return
+	std::string of JSON
+
+  @example
+	std::cout << data.query(&areasFilter, &measuresFilter, &yearsFilter).toJSON();
+*/
+std::string AreasView::toJSON() const
+{
+	std::ostringstream os;
+	this->writeJSON(os);
+	return os.str();
+}
+
+/*
+  Writes JSON to an output stream a piece at a time, formatting strings and
+  numbers in the same way as dumping a json object does. Output is collected in
+  a fixed buffer and written to the stream when it is full, as writing each
+  piece to the stream directly would be slower.
+*/
+class JSONWriter
+{
+private:
+	std::ostream &os;
+	char buffer[1 << 16];
+	size_t length = 0;
+
+public:
+	JSONWriter(std::ostream &os) : os(os) {}
+
+	// Make sure there are at least n bytes free in the buffer
+	void reserve(size_t n)
+	{
+		if (length + n > sizeof(buffer))
+		{
+			flush();
+		}
+	}
+
+	void flush()
+	{
+		os.write(buffer, length);
+		length = 0;
+	}
+
+	void raw(const char *str)
+	{
+		raw(str, std::strlen(str));
+	}
+
+	void raw(const char *str, size_t n)
+	{
+		if (n > sizeof(buffer))
+		{
+			flush();
+			os.write(str, n);
+			return;
+		}
+
+		reserve(n);
+		std::memcpy(buffer + length, str, n);
+		length += n;
+	}
+
+	// Write a quoted string, escaping it as the JSON library does (without
+	// ensure_ascii): only quotes, backslashes, and control characters
+	void string(const std::string &str)
+	{
+		raw("\"", 1);
+
+		const char *begin = str.data();
+		const char *end = begin + str.size();
+		const char *run = begin;
+
+		for (const char *c = begin; c != end; c++)
+		{
+			unsigned char byte = static_cast<unsigned char>(*c);
+			if (byte >= 0x20 && byte != '"' && byte != '\\')
+			{
+				continue;
+			}
+
+			raw(run, c - run);
+			run = c + 1;
+
+			switch (byte)
+			{
+			case '"':
+				raw("\\\"", 2);
+				break;
+			case '\\':
+				raw("\\\\", 2);
+				break;
+			case '\b':
+				raw("\\b", 2);
+				break;
+			case '\t':
+				raw("\\t", 2);
+				break;
+			case '\n':
+				raw("\\n", 2);
+				break;
+			case '\f':
+				raw("\\f", 2);
+				break;
+			case '\r':
+				raw("\\r", 2);
+				break;
+			default:
+				char escaped[7];
+				std::snprintf(escaped, sizeof(escaped), "\\u%04x", byte);
+				raw(escaped, 6);
+				break;
+			}
+		}
+
+		raw(run, end - run);
+		raw("\"", 1);
+	}
+
+	void number(unsigned int value)
+	{
+		reserve(10);
+
+		char digits[10];
+		size_t n = 0;
+		do
+		{
+			digits[n++] = '0' + value % 10;
+			value /= 10;
+		} while (value != 0);
+
+		while (n != 0)
+		{
+			buffer[length++] = digits[--n];
+		}
+	}
+
+	// Write a number in the shortest form that reads back as the same value,
+	// using the JSON library's own formatting (which gives e.g. 1.0 and not 1)
+	void number(double value)
+	{
+		if (!std::isfinite(value))
+		{
+			raw("null", 4);
+			return;
+		}
+
+		reserve(64);
+		char *end = nlohmann::detail::to_chars(buffer + length, buffer + length + 64, value);
+		length = end - buffer;
+	}
+};
+
+/*
+  As toJSON(), but write the JSON straight to an output stream as each Area is
+  reached, rather than building the whole document in memory first. The output
+  is the same as dumping the json object described at Areas::toJSON(): keys
+  are in sorted order, an Area (or Measure) with nothing to output is left
+  out, and numbers are formatted by the JSON library.
+
+  @param os
+	The output stream to write the JSON to
+
+  @return
+	void
+
+  @example
+	data.query(&areasFilter, nullptr, nullptr).writeJSON(std::cout);
+*/
+void AreasView::writeJSON(std::ostream &os) const
+{
+	JSONWriter writer(os);
+
+	if (this->size() == 0)
+	{
+		writer.raw("{}");
+		writer.flush();
+		return;
+	}
+
+	std::vector<std::pair<std::string, double>> sortedReadings;
+	bool firstArea = true;
+
+	for (auto &entry : this->areas)
+	{
+		const Area &area = entry.second.getArea();
+		const auto &measures = entry.second.getMeasures();
+		auto langs = area.getAllNames();
+		std::sort(langs.begin(), langs.end());
+
+		// A measure with no readings is left out, and so is an area with
+		// nothing left to output
+		bool hasMeasures = std::any_of(measures.begin(), measures.end(),
+									   [](const AreaView::value_type &measure) -> bool
+									   {
+										   return measure.second.size() != 0;
+									   });
+
+		if (!hasMeasures && langs.empty())
+		{
+			continue;
+		}
+
+		writer.raw(firstArea ? "{" : ",");
+		writer.string(SymbolTable::resolve(entry.first));
+		writer.raw(":{");
+		firstArea = false;
+
+		if (hasMeasures)
+		{
+			writer.raw("\"measures\":{");
+
+			bool firstMeasure = true;
+			for (auto &measure : measures)
+			{
+				const MeasureView &readings = measure.second;
+				if (readings.size() == 0)
+				{
+					continue;
+				}
+
+				if (!firstMeasure)
+				{
+					writer.raw(",");
+				}
+				firstMeasure = false;
+
+				writer.string(SymbolTable::resolve(measure.first));
+				writer.raw(":{");
+
+				// The years are keys, so they are sorted as strings. This is
+				// the order of the readings unless they have a different
+				// number of digits (e.g. 999 and 1000)
+				const unsigned int firstYear = (*readings.begin()).year;
+				const unsigned int lastYear = (*(readings.begin() + (readings.size() - 1))).year;
+				if (std::to_string(firstYear).size() == std::to_string(lastYear).size())
+				{
+					bool firstReading = true;
+					for (auto reading : readings)
+					{
+						writer.raw(firstReading ? "\"" : ",\"");
+						writer.number(reading.year);
+						writer.raw("\":");
+						writer.number(reading.value);
+						firstReading = false;
+					}
+				}
+				else
+				{
+					sortedReadings.clear();
+					for (auto reading : readings)
+					{
+						sortedReadings.push_back(std::make_pair(std::to_string(reading.year), reading.value));
+					}
+					std::sort(sortedReadings.begin(), sortedReadings.end());
+
+					for (size_t r = 0; r < sortedReadings.size(); r++)
+					{
+						writer.raw(r == 0 ? "" : ",");
+						writer.string(sortedReadings[r].first);
+						writer.raw(":");
+						writer.number(sortedReadings[r].second);
+					}
+				}
+
+				writer.raw("}");
+			}
+
+			writer.raw(langs.empty() ? "}" : "},");
+		}
+
+		if (!langs.empty())
+		{
+			writer.raw("\"names\":{");
+			for (size_t k = 0; k < langs.size(); k++)
+			{
+				writer.raw(k == 0 ? "" : ",");
+				writer.string(langs[k]);
+				writer.raw(":");
+				writer.string(area.getName(langs[k]));
+			}
+			writer.raw("}");
+		}
+
+		writer.raw("}");
+	}
+
+	// As with an empty json object, if no area had anything to output
+	writer.raw(firstArea ? "null" : "}");
+	writer.flush();
+}
+
+/*
+  Overload the << operator to print the tables of a view, in the same format
+  as for an Areas object.
+
+  @param os
+	The output stream to write to
+
+  @param view
+	The AreasView to write to the output stream
+
+  @return
+	Reference to the output stream
+
+  @example
+	std::cout << data.query(&areasFilter, &measuresFilter, &yearsFilter);
+*/
+std::ostream &operator<<(std::ostream &os, const AreasView &view)
+{
+	// Build up the tables of many areas before writing them to the stream
+	const size_t bufferSize = 1 << 16;
+	std::string buffer;
+	buffer.reserve(bufferSize);
+
+	for (auto &entry : view.areas)
+	{
+		appendTable(buffer, entry.second);
+
+		if (buffer.size() >= bufferSize)
+		{
+			os.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	}
+
+	os.write(buffer.data(), buffer.size());
+
+	return os;
+}
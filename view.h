@@ -0,0 +1,129 @@
+#ifndef VIEW_H_
+#define VIEW_H_
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 854378
+
+  This file contains the declarations of the views of imported data, which
+  select part of an Areas object with the same filters as the importers
+  (see Areas::query()) without copying any of it:
+
+  MeasureView   — A range of the readings of a Measure, e.g. those from 2000
+   |              to 2010.
+   |
+   +-> AreaView   An Area, with a MeasureView of each of its measures that is
+		|         selected.
+		|
+		+-> AreasView Every Area in an Areas object that is selected, in
+		              order of their local authority codes.
+
+  A view only refers to the Area and Measure objects it selects, so it must
+  not outlive the Areas object it is of, and it is invalidated by any change
+  to that object. The output of a view is the same as that of the copy of the
+  data that Areas::select() makes with the same filters, and unfiltered views
+  are how Areas, Area and Measure objects are output.
+ */
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "areas.h"
+
+/*
+  The readings of a Measure from one year to another, with the same
+  statistics as a Measure for just those readings.
+*/
+class MeasureView
+{
+private:
+	const Measure *measure;
+	Measure::const_iterator first;
+	Measure::const_iterator last;
+
+public:
+	MeasureView(const Measure &measure) noexcept;
+	MeasureView(const Measure &measure, unsigned int firstYear, unsigned int lastYear) noexcept;
+
+	const Measure &getMeasure() const noexcept;
+	const std::string &getCodename() const noexcept;
+	const std::string &getLabel() const noexcept;
+
+	const int size() const noexcept;
+	const double getDifference() const noexcept;
+	const double getDifferenceAsPercentage() const noexcept;
+	const double getAverage() const noexcept;
+
+	Measure::const_iterator begin() const noexcept;
+	Measure::const_iterator end() const noexcept;
+};
+
+void appendTable(std::string &out, const MeasureView &measure);
+
+/*
+  An Area and views of the measures of it that are selected, in order of
+  their codenames.
+*/
+class AreaView
+{
+public:
+	/*
+	  A view of a measure and the (lowercase) codename it is stored under in
+	  the Area, as in the Area's own container.
+	*/
+	using value_type = std::pair<Symbol, MeasureView>;
+
+private:
+	const Area *area;
+	std::vector<value_type> measures;
+
+public:
+	AreaView(const Area &area,
+			 const StringFilterSet *const measuresFilter = nullptr,
+			 const YearFilterTuple *const yearsFilter = nullptr);
+
+	const Area &getArea() const noexcept;
+	const std::vector<value_type> &getMeasures() const noexcept;
+
+	const int size() const noexcept;
+};
+
+void appendTable(std::string &out, const AreaView &area);
+
+/*
+  Views of the areas of an Areas object that are selected, in order of their
+  local authority codes.
+*/
+class AreasView
+{
+public:
+	/*
+	  A view of an area and the local authority code it is stored under in
+	  the Areas object.
+	*/
+	using value_type = std::pair<Symbol, AreaView>;
+
+private:
+	std::vector<value_type> areas;
+
+public:
+	AreasView(const Areas &areas,
+			  const StringFilterSet *const areasFilter = nullptr,
+			  const StringFilterSet *const measuresFilter = nullptr,
+			  const YearFilterTuple *const yearsFilter = nullptr);
+
+	const std::vector<value_type> &getAreas() const noexcept;
+	const int size() const noexcept;
+
+	std::string toJSON() const;
+	void writeJSON(std::ostream &os) const;
+
+	friend std::ostream &operator<<(std::ostream &os, const AreasView &view);
+};
+
+#endif // VIEW_H_